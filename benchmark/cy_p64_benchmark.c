@@ -0,0 +1,714 @@
+/***************************************************************************//**
+* \file cy_p64_benchmark.c
+* \version 1.0
+*
+* \brief
+* This is the source code file for the PSA crypto wrapper benchmark suite.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+/*******************************************************************************
+* Benchmark Prototypes
+****************************************************************************//**
+*
+* \defgroup benchmark     Benchmark
+*
+* \brief
+*  This suite measures the execution time of the PSA crypto wrappers over
+*  a payload size sweep and prints the results in the CSV format:
+*  hash, cipher CBC/CTR, MAC, sign, verify, ECDH, key derivation, random,
+*  memcpy and memset. The sha256-flash case hashes
+*  \ref CY_P64_BENCHMARK_FLASH_SIZE bytes directly from flash.
+*
+*  The suite is compiled only when CY_P64_BENCHMARK is defined, for example
+*  add DEFINES+=CY_P64_BENCHMARK to the application makefile. On the device,
+*  the time is measured by the DWT cycle counter of the CM4 core. The host
+*  build (see host/Makefile) defines CY_P64_BENCHMARK_HOST and measures the
+*  wrapper overhead against the host syscall stand-in in nanoseconds.
+*
+*  benchmark/cy_p64_benchmark_table.py converts the CSV output to the
+*  Performance table of README.md.
+*
+* \{
+*   \defgroup benchmark_api Functions
+*   \defgroup benchmark_macros Macros
+*   \defgroup benchmark_t Data Structures
+* \}
+*******************************************************************************/
+
+#if defined(CY_P64_BENCHMARK) || defined(CY_P64_BENCHMARK_HOST)
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "cy_device.h"
+#include "cy_p64_benchmark.h"
+#include "cy_p64_psacrypto.h"
+
+#if defined(CY_P64_BENCHMARK_HOST)
+    #include <time.h>
+    /* The host timebase is the monotonic clock in nanoseconds */
+    #define CY_P64_BENCHMARK_CLOCK_HZ       (1000000000UL)
+#else
+    #if !(CY_CPU_CORTEX_M4)
+        #error "The benchmark requires the DWT cycle counter of the CM4 core"
+    #endif
+    #define CY_P64_BENCHMARK_CLOCK_HZ       (SystemCoreClock)
+#endif /* CY_P64_BENCHMARK_HOST */
+
+#define CY_P64_BENCHMARK_LINE_SIZE          (96u)
+#define CY_P64_BENCHMARK_HASH_SIZE          (32u)
+#define CY_P64_BENCHMARK_SIGN_SIZE          (64u)
+#define CY_P64_BENCHMARK_PUB_KEY_SIZE       (65u)
+#define CY_P64_BENCHMARK_IV_SIZE            (16u)
+#define CY_P64_BENCHMARK_KDF_OUT_SIZE       (32u)
+
+typedef cy_p64_psa_status_t (*cy_p64_benchmark_func_t)(uint32_t size);
+
+typedef struct
+{
+    const char *name;                   /* The operation name in the CSV output */
+    cy_p64_benchmark_func_t func;       /* Runs the operation once */
+    bool sweep;                         /* The operation is measured for each payload size */
+    uint32_t size;                      /* The payload size when not measured for each size */
+} cy_p64_benchmark_case_t;
+
+typedef struct
+{
+    cy_p64_psa_key_handle_t aes128;
+    cy_p64_psa_key_handle_t aes256;
+    cy_p64_psa_key_handle_t hmac;
+    cy_p64_psa_key_handle_t sign_pair;
+    cy_p64_psa_key_handle_t sign_public;
+    cy_p64_psa_key_handle_t ecdh_pair;
+    cy_p64_psa_key_handle_t derive;
+    uint8_t peer_key[CY_P64_BENCHMARK_PUB_KEY_SIZE];
+    size_t peer_key_length;
+    uint8_t signature[CY_P64_BENCHMARK_SIGN_SIZE];
+    size_t signature_length;
+} cy_p64_benchmark_keys_t;
+
+static const uint32_t cy_p64_benchmark_sizes[] = { 16u, 64u, 256u, 1024u, 4096u, 10240u };
+
+static uint32_t cy_p64_benchmark_in[CY_P64_BENCHMARK_MAX_SIZE / sizeof(uint32_t)];
+static uint32_t cy_p64_benchmark_out[CY_P64_BENCHMARK_MAX_SIZE / sizeof(uint32_t)];
+static const uint8_t cy_p64_benchmark_iv[CY_P64_BENCHMARK_IV_SIZE] = { 0u };
+static const uint8_t cy_p64_benchmark_hash[CY_P64_BENCHMARK_HASH_SIZE] = { 0x5Au };
+static cy_p64_benchmark_keys_t cy_p64_benchmark_keys;
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_timer_init
+****************************************************************************//**
+* Starts the cycle counter.
+*******************************************************************************/
+static void cy_p64_benchmark_timer_init(void)
+{
+#if !defined(CY_P64_BENCHMARK_HOST)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0u;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif /* !CY_P64_BENCHMARK_HOST */
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_timer_read
+****************************************************************************//**
+* Reads the free-running 32-bit cycle counter.
+*
+* \return   The counter value.
+*******************************************************************************/
+static uint32_t cy_p64_benchmark_timer_read(void)
+{
+#if defined(CY_P64_BENCHMARK_HOST)
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(((uint64_t)ts.tv_sec * CY_P64_BENCHMARK_CLOCK_HZ) + (uint64_t)ts.tv_nsec);
+#else
+    return DWT->CYCCNT;
+#endif /* CY_P64_BENCHMARK_HOST */
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_cipher
+****************************************************************************//**
+* Decrypts the payload with a symmetric cipher.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_benchmark_cipher(cy_p64_psa_key_handle_t handle,
+                                                   cy_p64_psa_algorithm_t alg,
+                                                   uint32_t size)
+{
+    cy_p64_psa_status_t status;
+    cy_p64_psa_cipher_operation_t operation = CY_P64_PSA_CIPHER_OPERATION_INIT;
+    uint8_t *out = (uint8_t *)cy_p64_benchmark_out;
+    size_t out_length = 0u;
+    size_t finish_length = 0u;
+
+    status = cy_p64_psa_cipher_decrypt_setup(&operation, handle, alg);
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_psa_cipher_set_iv(&operation, cy_p64_benchmark_iv, sizeof(cy_p64_benchmark_iv));
+    }
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_psa_cipher_update(&operation, (const uint8_t *)cy_p64_benchmark_in, size,
+                                          out, sizeof(cy_p64_benchmark_out), &out_length);
+    }
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_psa_cipher_finish(&operation, &out[out_length],
+                                          sizeof(cy_p64_benchmark_out) - out_length, &finish_length);
+    }
+
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_hash_area
+****************************************************************************//**
+* Calculates the SHA-256 hash of the memory area.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_benchmark_hash_area(const uint8_t *data, uint32_t size)
+{
+    cy_p64_psa_status_t status;
+    cy_p64_psa_hash_operation_t operation = CY_P64_PSA_HASH_OPERATION_INIT;
+    uint8_t hash[CY_P64_BENCHMARK_HASH_SIZE];
+    size_t hash_length = 0u;
+
+    status = cy_p64_psa_hash_setup(&operation, CY_P64_PSA_ALG_SHA_256);
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_psa_hash_update(&operation, data, size);
+    }
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_psa_hash_finish(&operation, hash, sizeof(hash), &hash_length);
+    }
+
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_sha256
+****************************************************************************//**
+* Hashes the payload in RAM with SHA-256.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_benchmark_sha256(uint32_t size)
+{
+    return cy_p64_benchmark_hash_area((const uint8_t *)cy_p64_benchmark_in, size);
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_sha256_flash
+****************************************************************************//**
+* Hashes the payload directly from flash with SHA-256, at
+* \ref CY_P64_BENCHMARK_FLASH_ADDR.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_benchmark_sha256_flash(uint32_t size)
+{
+    return cy_p64_benchmark_hash_area((const uint8_t *)CY_P64_BENCHMARK_FLASH_ADDR, size);
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_aes_cbc_128
+****************************************************************************//**
+* Decrypts the payload with AES-CBC and the 128-bit key.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_benchmark_aes_cbc_128(uint32_t size)
+{
+    return cy_p64_benchmark_cipher(cy_p64_benchmark_keys.aes128, CY_P64_PSA_ALG_CBC_NO_PADDING, size);
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_aes_cbc_256
+****************************************************************************//**
+* Decrypts the payload with AES-CBC and the 256-bit key.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_benchmark_aes_cbc_256(uint32_t size)
+{
+    return cy_p64_benchmark_cipher(cy_p64_benchmark_keys.aes256, CY_P64_PSA_ALG_CBC_NO_PADDING, size);
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_aes_ctr_128
+****************************************************************************//**
+* Decrypts the payload with AES-CTR and the 128-bit key.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_benchmark_aes_ctr_128(uint32_t size)
+{
+    return cy_p64_benchmark_cipher(cy_p64_benchmark_keys.aes128, CY_P64_PSA_ALG_CTR, size);
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_aes_ctr_256
+****************************************************************************//**
+* Decrypts the payload with AES-CTR and the 256-bit key.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_benchmark_aes_ctr_256(uint32_t size)
+{
+    return cy_p64_benchmark_cipher(cy_p64_benchmark_keys.aes256, CY_P64_PSA_ALG_CTR, size);
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_hmac_sha256
+****************************************************************************//**
+* Verifies the HMAC-SHA256 of the payload.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_benchmark_hmac_sha256(uint32_t size)
+{
+    cy_p64_psa_status_t status;
+    cy_p64_psa_mac_operation_t operation = CY_P64_PSA_MAC_OPERATION_INIT;
+
+    status = cy_p64_psa_mac_verify_setup(&operation, cy_p64_benchmark_keys.hmac,
+                                         CY_P64_PSA_ALG_HMAC(CY_P64_PSA_ALG_SHA_256));
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_psa_mac_update(&operation, (const uint8_t *)cy_p64_benchmark_in, size);
+    }
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_psa_mac_verify_finish(&operation, cy_p64_benchmark_hash, sizeof(cy_p64_benchmark_hash));
+        /* The expected MAC is not known, the full calculation is done anyway */
+        if(status == CY_P64_PSA_ERROR_INVALID_SIGNATURE)
+        {
+            status = CY_P64_PSA_SUCCESS;
+        }
+    }
+
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_ecdsa_sign
+****************************************************************************//**
+* Signs the hash with the ECDSA secp256r1 key pair.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_benchmark_ecdsa_sign(uint32_t size)
+{
+    (void)size;
+    return cy_p64_psa_sign_hash(cy_p64_benchmark_keys.sign_pair, CY_P64_PSA_ALG_ECDSA(CY_P64_PSA_ALG_SHA_256),
+                                cy_p64_benchmark_hash, sizeof(cy_p64_benchmark_hash),
+                                cy_p64_benchmark_keys.signature, sizeof(cy_p64_benchmark_keys.signature),
+                                &cy_p64_benchmark_keys.signature_length);
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_ecdsa_verify
+****************************************************************************//**
+* Verifies the signature with the imported ECDSA secp256r1 public key.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_benchmark_ecdsa_verify(uint32_t size)
+{
+    (void)size;
+    return cy_p64_psa_verify_hash(cy_p64_benchmark_keys.sign_public, CY_P64_PSA_ALG_ECDSA(CY_P64_PSA_ALG_SHA_256),
+                                  cy_p64_benchmark_hash, sizeof(cy_p64_benchmark_hash),
+                                  cy_p64_benchmark_keys.signature, cy_p64_benchmark_keys.signature_length);
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_ecdsa_verify_pair
+****************************************************************************//**
+* Verifies the signature with the ECDSA secp256r1 key pair, including the
+* public key calculation.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_benchmark_ecdsa_verify_pair(uint32_t size)
+{
+    (void)size;
+    return cy_p64_psa_verify_hash(cy_p64_benchmark_keys.sign_pair, CY_P64_PSA_ALG_ECDSA(CY_P64_PSA_ALG_SHA_256),
+                                  cy_p64_benchmark_hash, sizeof(cy_p64_benchmark_hash),
+                                  cy_p64_benchmark_keys.signature, cy_p64_benchmark_keys.signature_length);
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_ecdh_generate
+****************************************************************************//**
+* Generates and destroys the ECDH secp256r1 key pair.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_benchmark_ecdh_generate(uint32_t size)
+{
+    cy_p64_psa_status_t status;
+    cy_p64_psa_key_attributes_t attributes = CY_P64_PSA_KEY_ATTRIBUTES_INIT;
+    cy_p64_psa_key_handle_t handle = 0u;
+
+    (void)size;
+    cy_p64_psa_set_key_type(&attributes, CY_P64_PSA_KEY_TYPE_ECC_KEY_PAIR(CY_P64_PSA_ECC_FAMILY_SECP_R1));
+    cy_p64_psa_set_key_bits(&attributes, 256u);
+    cy_p64_psa_set_key_usage_flags(&attributes, CY_P64_PSA_KEY_USAGE_DERIVE);
+    cy_p64_psa_set_key_algorithm(&attributes, CY_P64_PSA_ALG_ECDH);
+
+    status = cy_p64_psa_generate_key(&handle, &attributes);
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_psa_destroy_key(handle);
+    }
+
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_ecdh_handshake
+****************************************************************************//**
+* Runs the ECDH secp256r1 key agreement with the peer key and derives
+* the shared bytes with HKDF-SHA256.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_benchmark_ecdh_handshake(uint32_t size)
+{
+    cy_p64_psa_status_t status;
+    cy_p64_psa_key_derivation_operation_t operation = CY_P64_PSA_KEY_DERIVATION_OPERATION_INIT;
+
+    (void)size;
+    status = cy_p64_psa_key_derivation_setup(&operation,
+        CY_P64_PSA_ALG_KEY_AGREEMENT(CY_P64_PSA_ALG_ECDH, CY_P64_PSA_ALG_HKDF(CY_P64_PSA_ALG_SHA_256)));
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_psa_key_derivation_key_agreement(&operation, CY_P64_PSA_KEY_DERIVATION_INPUT_SECRET,
+                                                         cy_p64_benchmark_keys.ecdh_pair,
+                                                         cy_p64_benchmark_keys.peer_key,
+                                                         cy_p64_benchmark_keys.peer_key_length);
+    }
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_psa_key_derivation_out_bytes(&operation, (uint8_t *)cy_p64_benchmark_out,
+                                                     CY_P64_BENCHMARK_KDF_OUT_SIZE);
+    }
+    (void)cy_p64_psa_key_derivation_abort(&operation);
+
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_hkdf_sha256
+****************************************************************************//**
+* Derives the output bytes with HKDF-SHA256 from the derivation key.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_benchmark_hkdf_sha256(uint32_t size)
+{
+    cy_p64_psa_status_t status;
+    cy_p64_psa_key_derivation_operation_t operation = CY_P64_PSA_KEY_DERIVATION_OPERATION_INIT;
+
+    (void)size;
+    status = cy_p64_psa_key_derivation_setup(&operation, CY_P64_PSA_ALG_HKDF(CY_P64_PSA_ALG_SHA_256));
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_psa_key_derivation_inp_bytes(&operation, CY_P64_PSA_KEY_DERIVATION_INPUT_SALT,
+                                                     cy_p64_benchmark_hash, sizeof(cy_p64_benchmark_hash));
+    }
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_psa_key_derivation_inp_key(&operation, CY_P64_PSA_KEY_DERIVATION_INPUT_SECRET,
+                                                   cy_p64_benchmark_keys.derive);
+    }
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_psa_key_derivation_inp_bytes(&operation, CY_P64_PSA_KEY_DERIVATION_INPUT_INFO,
+                                                     cy_p64_benchmark_iv, sizeof(cy_p64_benchmark_iv));
+    }
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_psa_key_derivation_out_bytes(&operation, (uint8_t *)cy_p64_benchmark_out,
+                                                     CY_P64_BENCHMARK_KDF_OUT_SIZE);
+    }
+    (void)cy_p64_psa_key_derivation_abort(&operation);
+
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_random
+****************************************************************************//**
+* Generates the random payload.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_benchmark_random(uint32_t size)
+{
+    return cy_p64_psa_generate_random((uint8_t *)cy_p64_benchmark_out, size);
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_memcpy
+****************************************************************************//**
+* Copies the payload with cy_p64_psa_memcpy().
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_benchmark_memcpy(uint32_t size)
+{
+    return cy_p64_psa_memcpy(cy_p64_benchmark_out, cy_p64_benchmark_in, size);
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_memset
+****************************************************************************//**
+* Fills the payload with cy_p64_psa_memset().
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_benchmark_memset(uint32_t size)
+{
+    return cy_p64_psa_memset(cy_p64_benchmark_out, 0xA5u, size);
+}
+
+
+static const cy_p64_benchmark_case_t cy_p64_benchmark_cases[] =
+{
+    { "sha256",             cy_p64_benchmark_sha256,            true,  0u },
+    { "sha256-flash",       cy_p64_benchmark_sha256_flash,      false, CY_P64_BENCHMARK_FLASH_SIZE },
+    { "aes-cbc-128",        cy_p64_benchmark_aes_cbc_128,       true,  0u },
+    { "aes-cbc-256",        cy_p64_benchmark_aes_cbc_256,       true,  0u },
+    { "aes-ctr-128",        cy_p64_benchmark_aes_ctr_128,       true,  0u },
+    { "aes-ctr-256",        cy_p64_benchmark_aes_ctr_256,       true,  0u },
+    { "hmac-sha256",        cy_p64_benchmark_hmac_sha256,       true,  0u },
+    { "ecdsa-p256-sign",    cy_p64_benchmark_ecdsa_sign,        false, 0u },
+    { "ecdsa-p256-verify",  cy_p64_benchmark_ecdsa_verify,      false, 0u },
+    { "ecdsa-p256-verify-keypair", cy_p64_benchmark_ecdsa_verify_pair, false, 0u },
+    { "ecdh-p256-generate", cy_p64_benchmark_ecdh_generate,     false, 0u },
+    { "ecdh-p256-handshake", cy_p64_benchmark_ecdh_handshake,   false, 0u },
+    { "hkdf-sha256",        cy_p64_benchmark_hkdf_sha256,       false, 0u },
+    { "random",             cy_p64_benchmark_random,            true,  0u },
+    { "memcpy",             cy_p64_benchmark_memcpy,            true,  0u },
+    { "memset",             cy_p64_benchmark_memset,            true,  0u },
+};
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_generate
+****************************************************************************//**
+* Generates a volatile key for the benchmark.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_benchmark_generate(cy_p64_psa_key_handle_t *handle,
+                                                     cy_p64_psa_key_type_t type,
+                                                     size_t bits,
+                                                     cy_p64_psa_key_usage_t usage,
+                                                     cy_p64_psa_algorithm_t alg)
+{
+    cy_p64_psa_key_attributes_t attributes = CY_P64_PSA_KEY_ATTRIBUTES_INIT;
+
+    cy_p64_psa_set_key_type(&attributes, type);
+    cy_p64_psa_set_key_bits(&attributes, bits);
+    cy_p64_psa_set_key_usage_flags(&attributes, usage);
+    cy_p64_psa_set_key_algorithm(&attributes, alg);
+
+    return cy_p64_psa_generate_key(handle, &attributes);
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_setup
+****************************************************************************//**
+* Creates the keys used by the benchmark cases.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_benchmark_setup(void)
+{
+    cy_p64_psa_status_t status;
+    cy_p64_benchmark_keys_t *keys = &cy_p64_benchmark_keys;
+    cy_p64_psa_key_attributes_t attributes = CY_P64_PSA_KEY_ATTRIBUTES_INIT;
+    uint8_t pub_key[CY_P64_BENCHMARK_PUB_KEY_SIZE];
+    size_t pub_key_length = 0u;
+
+    status = cy_p64_benchmark_generate(&keys->aes128, CY_P64_PSA_KEY_TYPE_AES, 128u,
+                                       CY_P64_PSA_KEY_USAGE_DECRYPT, 0u);
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_benchmark_generate(&keys->aes256, CY_P64_PSA_KEY_TYPE_AES, 256u,
+                                           CY_P64_PSA_KEY_USAGE_DECRYPT, 0u);
+    }
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_benchmark_generate(&keys->hmac, CY_P64_PSA_KEY_TYPE_HMAC, 256u,
+                                           CY_P64_PSA_KEY_USAGE_VERIFY_HASH,
+                                           CY_P64_PSA_ALG_HMAC(CY_P64_PSA_ALG_SHA_256));
+    }
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_benchmark_generate(&keys->sign_pair,
+                                           CY_P64_PSA_KEY_TYPE_ECC_KEY_PAIR(CY_P64_PSA_ECC_FAMILY_SECP_R1), 256u,
+                                           CY_P64_PSA_KEY_USAGE_SIGN_HASH | CY_P64_PSA_KEY_USAGE_VERIFY_HASH,
+                                           CY_P64_PSA_ALG_ECDSA(CY_P64_PSA_ALG_SHA_256));
+    }
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_psa_export_public_key(keys->sign_pair, pub_key, sizeof(pub_key), &pub_key_length);
+    }
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        cy_p64_psa_set_key_type(&attributes, CY_P64_PSA_KEY_TYPE_ECC_PUBLIC_KEY(CY_P64_PSA_ECC_FAMILY_SECP_R1));
+        cy_p64_psa_set_key_bits(&attributes, 256u);
+        cy_p64_psa_set_key_usage_flags(&attributes, CY_P64_PSA_KEY_USAGE_VERIFY_HASH);
+        cy_p64_psa_set_key_algorithm(&attributes, CY_P64_PSA_ALG_ECDSA(CY_P64_PSA_ALG_SHA_256));
+        status = cy_p64_psa_import_key(&attributes, pub_key, pub_key_length, &keys->sign_public);
+    }
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        /* The signature for the verification cases */
+        status = cy_p64_benchmark_ecdsa_sign(0u);
+    }
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_benchmark_generate(&keys->ecdh_pair,
+                                           CY_P64_PSA_KEY_TYPE_ECC_KEY_PAIR(CY_P64_PSA_ECC_FAMILY_SECP_R1), 256u,
+                                           CY_P64_PSA_KEY_USAGE_DERIVE, CY_P64_PSA_ALG_ECDH);
+    }
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        /* The agreement with own public key costs the same as with a peer key */
+        status = cy_p64_psa_export_public_key(keys->ecdh_pair, keys->peer_key, sizeof(keys->peer_key),
+                                              &keys->peer_key_length);
+    }
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_benchmark_generate(&keys->derive, CY_P64_PSA_KEY_TYPE_DERIVE, 256u,
+                                           CY_P64_PSA_KEY_USAGE_DERIVE, CY_P64_PSA_ALG_HKDF(CY_P64_PSA_ALG_SHA_256));
+    }
+
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_cleanup
+****************************************************************************//**
+* Destroys the keys created by cy_p64_benchmark_setup().
+*******************************************************************************/
+static void cy_p64_benchmark_cleanup(void)
+{
+    cy_p64_benchmark_keys_t *keys = &cy_p64_benchmark_keys;
+    cy_p64_psa_key_handle_t *handles[] = { &keys->aes128, &keys->aes256, &keys->hmac, &keys->sign_pair,
+                                           &keys->sign_public, &keys->ecdh_pair, &keys->derive };
+    uint32_t i;
+
+    for(i = 0u; i < (sizeof(handles) / sizeof(handles[0])); i++)
+    {
+        if(*handles[i] != 0u)
+        {
+            (void)cy_p64_psa_destroy_key(*handles[i]);
+            *handles[i] = 0u;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_measure
+****************************************************************************//**
+* Runs the case \ref CY_P64_BENCHMARK_ITERATIONS times and prints the average.
+*******************************************************************************/
+static void cy_p64_benchmark_measure(const cy_p64_benchmark_case_t *bench_case,
+                                     uint32_t size,
+                                     cy_p64_benchmark_print_t print)
+{
+    char line[CY_P64_BENCHMARK_LINE_SIZE];
+    cy_p64_psa_status_t status = CY_P64_PSA_SUCCESS;
+    uint64_t total = 0u;
+    uint32_t start;
+    uint32_t cycles;
+    uint32_t i;
+
+    for(i = 0u; (i < CY_P64_BENCHMARK_ITERATIONS) && (status == CY_P64_PSA_SUCCESS); i++)
+    {
+        start = cy_p64_benchmark_timer_read();
+        status = bench_case->func(size);
+        total += (uint32_t)(cy_p64_benchmark_timer_read() - start);
+    }
+
+    cycles = (uint32_t)(total / i);
+    (void)snprintf(line, sizeof(line), "%s,%lu,%lu,%lu,%lu,0x%08lX",
+                   bench_case->name,
+                   (unsigned long)size,
+                   (unsigned long)i,
+                   (unsigned long)cycles,
+                   (unsigned long)(((uint64_t)cycles * 1000000u) / CY_P64_BENCHMARK_CLOCK_HZ),
+                   (unsigned long)status);
+    print(line);
+}
+
+
+/*******************************************************************************
+* Function Prototypes
+****************************************************************************//**
+*
+*  \addtogroup benchmark_api
+*
+*  \{
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: cy_p64_benchmark_run
+****************************************************************************//**
+* Runs all benchmark cases and prints the results in the CSV format, starting
+* with the \ref CY_P64_BENCHMARK_CSV_HEADER line. The payload operations are
+* measured for each size of the sweep up to \ref CY_P64_BENCHMARK_MAX_SIZE,
+* the others with their fixed size, 0 for the operations without payload.
+*
+* \param[in] print      The function that prints one CSV line.
+* \return     \ref CY_P64_SUCCESS for success or the error code of the key
+*             creation. The errors of the separate cases are printed in the
+*             status column.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_benchmark_run(cy_p64_benchmark_print_t print)
+{
+    cy_p64_error_codes_t ret;
+    uint32_t i;
+    uint32_t j;
+
+    if(print == NULL)
+    {
+        ret = CY_P64_INVALID_ARGUMENT;
+    }
+    else
+    {
+        cy_p64_benchmark_timer_init();
+
+        ret = cy_p64_benchmark_setup();
+        if(ret == CY_P64_SUCCESS)
+        {
+            print(CY_P64_BENCHMARK_CSV_HEADER);
+
+            for(i = 0u; i < (sizeof(cy_p64_benchmark_cases) / sizeof(cy_p64_benchmark_cases[0])); i++)
+            {
+                if(cy_p64_benchmark_cases[i].sweep)
+                {
+                    for(j = 0u; j < (sizeof(cy_p64_benchmark_sizes) / sizeof(cy_p64_benchmark_sizes[0])); j++)
+                    {
+                        if(cy_p64_benchmark_sizes[j] <= CY_P64_BENCHMARK_MAX_SIZE)
+                        {
+                            cy_p64_benchmark_measure(&cy_p64_benchmark_cases[i], cy_p64_benchmark_sizes[j], print);
+                        }
+                    }
+                }
+                else
+                {
+                    cy_p64_benchmark_measure(&cy_p64_benchmark_cases[i], cy_p64_benchmark_cases[i].size, print);
+                }
+            }
+        }
+
+        cy_p64_benchmark_cleanup();
+    }
+
+    return ret;
+}
+
+/** \} */
+
+#endif /* CY_P64_BENCHMARK || CY_P64_BENCHMARK_HOST */
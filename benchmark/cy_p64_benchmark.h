@@ -0,0 +1,66 @@
+/***************************************************************************//**
+* \file cy_p64_benchmark.h
+* \version 1.0
+*
+* \brief
+* This is the header file for the PSA crypto wrapper benchmark suite.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef CY_P64_BENCHMARK_H
+#define CY_P64_BENCHMARK_H
+
+#include <stdint.h>
+#include "cy_p64_syscall.h"
+
+/** \addtogroup benchmark_macros
+ * \{
+ */
+
+/** The largest payload size of the size sweep, the suite allocates two static
+ * buffers of this size. */
+#ifndef CY_P64_BENCHMARK_MAX_SIZE
+#define CY_P64_BENCHMARK_MAX_SIZE           (10240u)
+#endif /* CY_P64_BENCHMARK_MAX_SIZE */
+
+/** The start address of the flash area hashed by the sha256-flash case */
+#ifndef CY_P64_BENCHMARK_FLASH_ADDR
+#define CY_P64_BENCHMARK_FLASH_ADDR         (CY_FLASH_BASE)
+#endif /* CY_P64_BENCHMARK_FLASH_ADDR */
+
+/** The size of the flash area hashed by the sha256-flash case */
+#ifndef CY_P64_BENCHMARK_FLASH_SIZE
+#define CY_P64_BENCHMARK_FLASH_SIZE         (102400u)
+#endif /* CY_P64_BENCHMARK_FLASH_SIZE */
+
+/** The number of runs averaged for each measurement */
+#ifndef CY_P64_BENCHMARK_ITERATIONS
+#define CY_P64_BENCHMARK_ITERATIONS         (4u)
+#endif /* CY_P64_BENCHMARK_ITERATIONS */
+
+/** The header line of the CSV output */
+#define CY_P64_BENCHMARK_CSV_HEADER         "operation,size,iterations,cycles,us,status"
+
+/** \} */
+
+/** \addtogroup benchmark_t
+ * \{
+ */
+
+/** Prints one line of the CSV output, the line does not contain the new line
+ * character. */
+typedef void (*cy_p64_benchmark_print_t)(const char *line);
+
+/** \} */
+
+/* Public APIs */
+cy_p64_error_codes_t cy_p64_benchmark_run(cy_p64_benchmark_print_t print);
+
+#endif /* CY_P64_BENCHMARK_H */
@@ -0,0 +1,59 @@
+#!/usr/bin/env python3
+################################################################################
+# \file cy_p64_benchmark_table.py
+# \version 1.0
+#
+# \brief
+# Converts the CSV output of cy_p64_benchmark_run() to the Performance table
+# of README.md.
+#
+# Usage: cy_p64_benchmark_table.py [bench.csv]   (reads stdin by default)
+#
+################################################################################
+# \copyright
+# Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+# All rights reserved.
+# You may use this file only in accordance with the license, terms, conditions,
+# disclaimers, and limitations in the end user license agreement accompanying
+# the software package with which this file was provided.
+################################################################################
+
+import csv
+import sys
+
+# (operation, size, algorithm column, execution time suffix)
+ROWS = [
+    ("sha256",                    10240, "SHA-256",         "ms/10kB payload"),
+    ("sha256-flash",              102400, "SHA-256",        "ms/100kB payload (from flash)"),
+    ("aes-cbc-128",               10240, "AES-CBC-128",     "ms/10kB payload"),
+    ("aes-cbc-256",               10240, "AES-CBC-256",     "ms/10kB payload"),
+    ("aes-ctr-128",               10240, "AES-CTR-128",     "ms/10kB payload"),
+    ("aes-ctr-256",               10240, "AES-CTR-256",     "ms/10kB payload"),
+    ("hmac-sha256",               10240, "HMAC-SHA256",     "ms/10kB payload"),
+    ("ecdsa-p256-sign",           0,     "ECDSA-secp256r1", "ms/sign"),
+    ("ecdsa-p256-verify",         0,     "ECDSA-secp256r1", "ms/verify"),
+    ("ecdsa-p256-verify-keypair", 0,     "ECDSA-secp256r1",
+     "ms/verify (including public key calculation)"),
+    ("ecdh-p256-generate",        0,     "ECDH-secp256r1",  "ms/generate key pair"),
+    ("ecdh-p256-handshake",       0,     "ECDH-secp256r1",  "ms/handshake"),
+    ("hkdf-sha256",               0,     "HKDF-SHA256",     "ms/32B output"),
+]
+
+
+def main():
+    source = open(sys.argv[1], newline="") if len(sys.argv) > 1 else sys.stdin
+    results = {}
+    for row in csv.DictReader(source):
+        if int(row["status"], 16) == 0xA0000000:
+            results[(row["operation"], int(row["size"]))] = int(row["us"])
+
+    print("Algorithm       | Execution time  ")
+    print("----------------| -------------  ")
+    for operation, size, name, suffix in ROWS:
+        if (operation, size) in results:
+            ms = round(results[(operation, size)] / 1000)
+            print("{:<16}| {:<3} {}  ".format(name, ms, suffix))
+
+
+if __name__ == "__main__":
+    main()
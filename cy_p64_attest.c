@@ -0,0 +1,585 @@
+/***************************************************************************//**
+* \file cy_p64_attest.c
+* \version 1.0
+*
+* \brief
+* This is the source code file for the attestation planner functions.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+/*******************************************************************************
+* Attestation planner Prototypes
+****************************************************************************//**
+*
+* \defgroup attest     Attestation planner
+*
+* \brief
+*  This library prepares the memory region list for cy_p64_attestation().
+*  cy_p64_attest_plan() sorts the requested regions, merges the overlapping
+*  and adjacent ones and splits the regions larger than
+*  \ref CY_P64_ATTEST_REGION_MAX_SIZE.
+*
+*  The region hashes returned by the syscall are kept in a cache together with
+*  the flash write generation of the region. The application reports flash
+*  writes with cy_p64_attest_flash_written() (the image functions of this
+*  library do it), so the plan tells which regions changed since they were
+*  attested last time. The regions outside the main flash are always reported
+*  as changed.
+*
+*  The syscall salts each region hash with its own random number, so the
+*  regions passed to the syscall are always hashed again. When the server
+*  protocol accepts the hashes of the unchanged regions from the previous
+*  attestation, cy_p64_attest_plan() with reuse_unchanged set leaves them out
+*  of the syscall and fills their hashes from the cache.
+*
+*  cy_p64_attest_response_build() encodes the attestation response (random
+*  numbers, device UID, region hashes and signature) to base64 in one pass,
+*  without the heap, into the caller buffer or through the sink callback.
+*
+*  The functions are not re-entrant.
+*
+* \{
+*   \defgroup attest_api Functions
+*   \defgroup attest_macros Macros
+*   \defgroup attest_t Data Structures
+* \}
+*******************************************************************************/
+
+#include <string.h>
+#include "cy_p64_attest.h"
+#include "cy_p64_base64.h"
+
+/* The number of the binary bytes encoded at once, must be a multiple of 3 */
+#define CY_P64_ATTEST_ENCODE_CHUNK          (48u)
+
+typedef struct
+{
+    uint32_t start;                 /* The start address, the size is 0 for the free entry */
+    uint32_t size;                  /* The size in bytes */
+    uint32_t hash_gen;              /* The flash write generation when the hash was calculated */
+    uint32_t write_gen;             /* The flash write generation of the last write to the region */
+    uint8_t hash[CY_P64_ATTEST_HASH_SIZE];
+} cy_p64_attest_cache_entry_t;
+
+typedef struct
+{
+    uint8_t pending[CY_P64_ATTEST_ENCODE_CHUNK]; /* The binary bytes not encoded yet */
+    uint32_t pending_length;
+    char *buffer;                   /* The output buffer or NULL for the sink */
+    uint32_t buffer_size;
+    uint32_t length;                /* The number of the base64 characters output */
+    cy_p64_attest_sink_t sink;
+    void *sink_arg;
+} cy_p64_attest_writer_t;
+
+static cy_p64_attest_cache_entry_t cy_p64_attest_cache[CY_P64_ATTEST_CACHE_SIZE];
+static uint32_t cy_p64_attest_cache_victim = 0u;
+static uint32_t cy_p64_attest_generation = 0u;
+
+
+/*******************************************************************************
+* Function Name: cy_p64_attest_overlaps
+****************************************************************************//**
+* Checks if two memory ranges overlap.
+*******************************************************************************/
+static bool cy_p64_attest_overlaps(uint32_t start_a, uint32_t size_a, uint32_t start_b, uint32_t size_b)
+{
+    return (start_a < (start_b + size_b)) && (start_b < (start_a + size_a));
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_attest_is_tracked
+****************************************************************************//**
+* Checks if the writes to the region are reported with
+* cy_p64_attest_flash_written(): the region is in the main flash.
+*******************************************************************************/
+static bool cy_p64_attest_is_tracked(uint32_t start, uint32_t size)
+{
+    return (start >= CY_FLASH_BASE) && ((start - CY_FLASH_BASE) <= CY_FLASH_SIZE) &&
+           (size <= (CY_FLASH_SIZE - (start - CY_FLASH_BASE)));
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_attest_cache_find
+****************************************************************************//**
+* Finds the cache entry of the region.
+*******************************************************************************/
+static cy_p64_attest_cache_entry_t *cy_p64_attest_cache_find(uint32_t start, uint32_t size)
+{
+    cy_p64_attest_cache_entry_t *entry = NULL;
+    uint32_t i;
+
+    for(i = 0u; (i < CY_P64_ATTEST_CACHE_SIZE) && (entry == NULL); i++)
+    {
+        if((cy_p64_attest_cache[i].size == size) && (cy_p64_attest_cache[i].start == start))
+        {
+            entry = &cy_p64_attest_cache[i];
+        }
+    }
+    return entry;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_attest_writer_flush
+****************************************************************************//**
+* Encodes the pending bytes and outputs the base64 characters. The chunks are
+* a multiple of 3 bytes except the last one, so the output is the same as
+* the base64 encoding of the whole response.
+*******************************************************************************/
+static cy_p64_error_codes_t cy_p64_attest_writer_flush(cy_p64_attest_writer_t *writer)
+{
+    cy_p64_error_codes_t ret = CY_P64_SUCCESS;
+    unsigned char encoded[CY_P64_GET_B64_ENCODE_LEN(CY_P64_ATTEST_ENCODE_CHUNK)];
+    int encoded_length;
+
+    if(writer->pending_length > 0u)
+    {
+        encoded_length = cy_p64_base64_encode(writer->pending, (int32_t)writer->pending_length,
+                                              encoded, sizeof(encoded), CY_P64_BASE64_STANDARD);
+        writer->pending_length = 0u;
+
+        if(encoded_length < 0)
+        {
+            ret = CY_P64_INVALID;
+        }
+        else if(writer->sink != NULL)
+        {
+            ret = writer->sink((const char *)encoded, (uint32_t)encoded_length, writer->sink_arg);
+        }
+        else if((writer->buffer_size - writer->length) <= (uint32_t)encoded_length)
+        {
+            /* No space for the characters and the terminating null */
+            ret = CY_P64_INVALID_OUT_PAR;
+        }
+        else
+        {
+            (void)memcpy(&writer->buffer[writer->length], encoded, (uint32_t)encoded_length);
+        }
+
+        if(ret == CY_P64_SUCCESS)
+        {
+            writer->length += (uint32_t)encoded_length;
+        }
+    }
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_attest_writer_put
+****************************************************************************//**
+* Appends the binary data to the response.
+*******************************************************************************/
+static cy_p64_error_codes_t cy_p64_attest_writer_put(cy_p64_attest_writer_t *writer,
+                                                     const uint8_t *data,
+                                                     uint32_t size)
+{
+    cy_p64_error_codes_t ret = CY_P64_SUCCESS;
+    uint32_t offset = 0u;
+    uint32_t chunk;
+
+    while((ret == CY_P64_SUCCESS) && (offset < size))
+    {
+        chunk = CY_P64_ATTEST_ENCODE_CHUNK - writer->pending_length;
+        if(chunk > (size - offset))
+        {
+            chunk = size - offset;
+        }
+        (void)memcpy(&writer->pending[writer->pending_length], &data[offset], chunk);
+        writer->pending_length += chunk;
+        offset += chunk;
+
+        if(writer->pending_length == CY_P64_ATTEST_ENCODE_CHUNK)
+        {
+            ret = cy_p64_attest_writer_flush(writer);
+        }
+    }
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_attest_writer_put_u32
+****************************************************************************//**
+* Appends the little-endian 32-bit value to the response.
+*******************************************************************************/
+static cy_p64_error_codes_t cy_p64_attest_writer_put_u32(cy_p64_attest_writer_t *writer, uint32_t value)
+{
+    uint8_t data[4u];
+
+    data[0] = CY_LO8(value);
+    data[1] = CY_LO8(value >> 8u);
+    data[2] = CY_LO8(value >> 16u);
+    data[3] = CY_LO8(value >> 24u);
+
+    return cy_p64_attest_writer_put(writer, data, sizeof(data));
+}
+
+
+/*******************************************************************************
+* Function Prototypes
+****************************************************************************//**
+*
+*  \addtogroup attest_api
+*
+*  \{
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: cy_p64_attest_flash_written
+****************************************************************************//**
+* Reports the flash write. Starts a new flash write generation and marks
+* the cached regions which overlap the written range as changed.
+*
+* \param[in] address        The start address of the written range.
+* \param[in] size           The size of the written range.
+*******************************************************************************/
+void cy_p64_attest_flash_written(uint32_t address, uint32_t size)
+{
+    uint32_t i;
+
+    cy_p64_attest_generation++;
+
+    for(i = 0u; i < CY_P64_ATTEST_CACHE_SIZE; i++)
+    {
+        if((cy_p64_attest_cache[i].size != 0u) &&
+           cy_p64_attest_overlaps(cy_p64_attest_cache[i].start, cy_p64_attest_cache[i].size, address, size))
+        {
+            cy_p64_attest_cache[i].write_gen = cy_p64_attest_generation;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_attest_cache_clear
+****************************************************************************//**
+* Clears the region hash cache, all regions are reported as changed
+* by the next plan.
+*******************************************************************************/
+void cy_p64_attest_cache_clear(void)
+{
+    (void)memset(cy_p64_attest_cache, 0, sizeof(cy_p64_attest_cache));
+    cy_p64_attest_cache_victim = 0u;
+}
+
+#ifndef CY_DEVICE_PSOC6A512K
+
+/*******************************************************************************
+* Function Name: cy_p64_attest_plan
+****************************************************************************//**
+* Prepares the attestation plan: sorts the regions by address, merges the
+* overlapping and adjacent regions, splits the regions larger than
+* \ref CY_P64_ATTEST_REGION_MAX_SIZE and marks the changed regions.
+*
+* \param[out] plan          The attestation plan.
+* \param[in] regions        The requested regions.
+* \param[in] count          The number of the requested regions.
+* \param[in] reuse_unchanged Leave the unchanged regions with the cached hash
+*                           out of the syscall. Use it only when the server
+*                           accepts the hashes from the previous attestation.
+* \return     \ref CY_P64_SUCCESS for success,
+*             \ref CY_P64_INVALID_ARGUMENT if the regions are empty, wrap
+*             around the address space or do not fit in
+*             \ref CY_P64_ATTEST_MAX_REGIONS after splitting.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_attest_plan(cy_p64_attest_plan_t *plan,
+                                        const cy_p64_attest_region_t *regions,
+                                        uint32_t count,
+                                        bool reuse_unchanged)
+{
+    cy_p64_error_codes_t ret = CY_P64_SUCCESS;
+    cy_p64_attest_region_t sorted[CY_P64_ATTEST_MAX_REGIONS];
+    cy_p64_attest_region_t region;
+    cy_p64_attest_plan_region_t *planned;
+    const cy_p64_attest_cache_entry_t *entry;
+    uint32_t sorted_count = 0u;
+    uint32_t end;
+    uint32_t i;
+    uint32_t j;
+
+    if((plan == NULL) || (regions == NULL) || (count == 0u))
+    {
+        ret = CY_P64_INVALID_ARGUMENT;
+    }
+
+    /* Insertion sort by the start address, merging the overlapping and adjacent regions */
+    for(i = 0u; (i < count) && (ret == CY_P64_SUCCESS); i++)
+    {
+        region = regions[i];
+        if((region.size == 0u) || ((region.start + region.size) < region.start))
+        {
+            ret = CY_P64_INVALID_ARGUMENT;
+        }
+        else if(sorted_count == CY_P64_ATTEST_MAX_REGIONS)
+        {
+            ret = CY_P64_INVALID_ARGUMENT;
+        }
+        else
+        {
+            j = sorted_count;
+            while((j > 0u) && (sorted[j - 1u].start > region.start))
+            {
+                sorted[j] = sorted[j - 1u];
+                j--;
+            }
+            sorted[j] = region;
+            sorted_count++;
+        }
+    }
+
+    if(ret == CY_P64_SUCCESS)
+    {
+        j = 0u;
+        for(i = 1u; i < sorted_count; i++)
+        {
+            end = sorted[j].start + sorted[j].size;
+            if(sorted[i].start <= end)
+            {
+                if((sorted[i].start + sorted[i].size) > end)
+                {
+                    sorted[j].size = (sorted[i].start + sorted[i].size) - sorted[j].start;
+                }
+            }
+            else
+            {
+                j++;
+                sorted[j] = sorted[i];
+            }
+        }
+        sorted_count = j + 1u;
+
+        (void)memset(plan, 0, sizeof(*plan));
+    }
+
+    /* Split the large regions */
+    for(i = 0u; (i < sorted_count) && (ret == CY_P64_SUCCESS); i++)
+    {
+        region = sorted[i];
+        while((region.size > 0u) && (ret == CY_P64_SUCCESS))
+        {
+            if(plan->region_count == CY_P64_ATTEST_MAX_REGIONS)
+            {
+                ret = CY_P64_INVALID_ARGUMENT;
+            }
+            else
+            {
+                planned = &plan->regions[plan->region_count];
+                planned->start = region.start;
+                planned->size = (region.size > CY_P64_ATTEST_REGION_MAX_SIZE) ?
+                                CY_P64_ATTEST_REGION_MAX_SIZE : region.size;
+                region.start += planned->size;
+                region.size -= planned->size;
+                plan->region_count++;
+            }
+        }
+    }
+
+    /* Mark the changed regions and select the regions for the syscall */
+    for(i = 0u; (ret == CY_P64_SUCCESS) && (i < plan->region_count); i++)
+    {
+        planned = &plan->regions[i];
+        entry = cy_p64_attest_cache_find(planned->start, planned->size);
+        planned->changed = (entry == NULL) || (entry->write_gen != entry->hash_gen) ||
+                           (!cy_p64_attest_is_tracked(planned->start, planned->size));
+
+        if(reuse_unchanged && (!planned->changed))
+        {
+            planned->reused = true;
+            (void)memcpy(planned->hash, entry->hash, sizeof(planned->hash));
+        }
+        else
+        {
+            plan->mem_start[plan->mem_count] = planned->start;
+            plan->mem_size[plan->mem_count] = planned->size;
+            plan->mem_count++;
+        }
+    }
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_attest_run
+****************************************************************************//**
+* Calls cy_p64_attestation() for the planned regions, copies the region hashes
+* to the plan and stores them in the cache.
+*
+* \param[in,out] plan       The attestation plan from cy_p64_attest_plan().
+* \param[in] sign_alg       PSA signing algorithm, see cy_p64_attestation().
+* \param[in] rnd            A random number from the server.
+* \return     \ref CY_P64_SUCCESS for success or error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_attest_run(cy_p64_attest_plan_t *plan, uint32_t sign_alg, uint32_t rnd)
+{
+    cy_p64_error_codes_t ret;
+    cy_p64_attest_plan_region_t *planned;
+    cy_p64_attest_cache_entry_t *entry;
+    uint32_t mem_hash_size = 0u;
+    uint32_t hash_index = 0u;
+    uint32_t i;
+
+    if(plan == NULL)
+    {
+        ret = CY_P64_INVALID_ARGUMENT;
+    }
+    else
+    {
+        ret = cy_p64_attestation(sign_alg, rnd, plan->mem_count, plan->mem_start, plan->mem_size,
+                                 plan->mem_hash, plan->mem_count * CY_P64_ATTEST_HASH_SIZE,
+                                 &plan->rnd_out, &mem_hash_size, &plan->sign_size, &plan->sign_addr);
+        if((ret == CY_P64_SUCCESS) && (mem_hash_size != CY_P64_ATTEST_HASH_SIZE))
+        {
+            ret = CY_P64_INVALID;
+        }
+
+        for(i = 0u; (ret == CY_P64_SUCCESS) && (i < plan->region_count); i++)
+        {
+            planned = &plan->regions[i];
+            if(!planned->reused)
+            {
+                (void)memcpy(planned->hash, &((const uint8_t *)plan->mem_hash)[hash_index * CY_P64_ATTEST_HASH_SIZE],
+                             CY_P64_ATTEST_HASH_SIZE);
+                hash_index++;
+
+                if(cy_p64_attest_is_tracked(planned->start, planned->size))
+                {
+                    entry = cy_p64_attest_cache_find(planned->start, planned->size);
+                    if(entry == NULL)
+                    {
+                        entry = &cy_p64_attest_cache[cy_p64_attest_cache_victim];
+                        cy_p64_attest_cache_victim = (cy_p64_attest_cache_victim + 1u) % CY_P64_ATTEST_CACHE_SIZE;
+                        entry->start = planned->start;
+                        entry->size = planned->size;
+                    }
+                    entry->hash_gen = cy_p64_attest_generation;
+                    entry->write_gen = cy_p64_attest_generation;
+                    (void)memcpy(entry->hash, planned->hash, sizeof(entry->hash));
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_attest_response_build
+****************************************************************************//**
+* Encodes the attestation response to base64 in one pass. The binary response
+* contains the little-endian 32-bit values and the byte arrays:
+* * Server random number, syscall random number
+* * Device UID (SFLASH DIE_LOT..DIE_YEAR, 11 bytes)
+* * Number of memory regions
+* * for each memory region: address, size, hash
+* * Signature size, signature
+*
+* The response is written either to the buffer or to the sink callback.
+* The buffer gets the terminating null character, use
+* \ref CY_P64_ATTEST_RESPONSE_SIZE() to calculate the buffer size.
+*
+* \param[in] response       The attestation results.
+* \param[out] buffer        The output buffer, NULL when the sink is used.
+* \param[in] buffer_size    The size of the output buffer.
+* \param[out] length        The number of the base64 characters output,
+*                           can be NULL.
+* \param[in] sink           The output sink, NULL when the buffer is used.
+* \param[in] sink_arg       The user argument passed to \p sink.
+* \return     \ref CY_P64_SUCCESS for success,
+*             \ref CY_P64_INVALID_OUT_PAR if the buffer is too small
+*             or the error code returned by the sink.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_attest_response_build(const cy_p64_attest_response_t *response,
+                                                  char *buffer,
+                                                  uint32_t buffer_size,
+                                                  uint32_t *length,
+                                                  cy_p64_attest_sink_t sink,
+                                                  void *sink_arg)
+{
+    cy_p64_error_codes_t ret = CY_P64_SUCCESS;
+    cy_p64_attest_writer_t writer;
+    uint32_t i;
+
+    if((response == NULL) || ((buffer == NULL) == (sink == NULL)) || ((buffer != NULL) && (buffer_size == 0u)) ||
+       ((response->mem_count > 0u) && ((response->mem_start == NULL) || (response->mem_size == NULL) ||
+                                       (response->mem_hash == NULL))) ||
+       ((response->sign == NULL) && (response->sign_size > 0u)))
+    {
+        ret = CY_P64_INVALID_ARGUMENT;
+    }
+    else
+    {
+        (void)memset(&writer, 0, sizeof(writer));
+        writer.buffer = buffer;
+        writer.buffer_size = buffer_size;
+        writer.sink = sink;
+        writer.sink_arg = sink_arg;
+
+        ret = cy_p64_attest_writer_put_u32(&writer, response->rnd);
+        if(ret == CY_P64_SUCCESS)
+        {
+            ret = cy_p64_attest_writer_put_u32(&writer, response->rnd_out);
+        }
+        if(ret == CY_P64_SUCCESS)
+        {
+            ret = cy_p64_attest_writer_put(&writer, (const uint8_t *)&SFLASH->DIE_LOT[0], CY_P64_ATTEST_UID_SIZE);
+        }
+        if(ret == CY_P64_SUCCESS)
+        {
+            ret = cy_p64_attest_writer_put_u32(&writer, response->mem_count);
+        }
+        for(i = 0u; (ret == CY_P64_SUCCESS) && (i < response->mem_count); i++)
+        {
+            ret = cy_p64_attest_writer_put_u32(&writer, response->mem_start[i]);
+            if(ret == CY_P64_SUCCESS)
+            {
+                ret = cy_p64_attest_writer_put_u32(&writer, response->mem_size[i]);
+            }
+            if(ret == CY_P64_SUCCESS)
+            {
+                ret = cy_p64_attest_writer_put(&writer, &response->mem_hash[i * response->mem_hash_size],
+                                               response->mem_hash_size);
+            }
+        }
+        if(ret == CY_P64_SUCCESS)
+        {
+            ret = cy_p64_attest_writer_put_u32(&writer, response->sign_size);
+        }
+        if(ret == CY_P64_SUCCESS)
+        {
+            ret = cy_p64_attest_writer_put(&writer, response->sign, response->sign_size);
+        }
+        if(ret == CY_P64_SUCCESS)
+        {
+            ret = cy_p64_attest_writer_flush(&writer);
+        }
+
+        if(buffer != NULL)
+        {
+            /* The flush keeps the space for the terminating null */
+            buffer[(ret == CY_P64_SUCCESS) ? writer.length : 0u] = '\0';
+        }
+        if(length != NULL)
+        {
+            *length = (ret == CY_P64_SUCCESS) ? writer.length : 0u;
+        }
+    }
+
+    return ret;
+}
+
+#endif /* !CY_DEVICE_PSOC6A512K */
+
+/** \} */
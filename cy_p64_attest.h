@@ -0,0 +1,144 @@
+/***************************************************************************//**
+* \file cy_p64_attest.h
+* \version 1.0
+*
+* \brief
+* This is the header file for the attestation planner functions.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef CY_P64_ATTEST_H
+#define CY_P64_ATTEST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_p64_syscalls.h"
+
+/** \addtogroup attest_macros
+ * \{
+ */
+
+/** The maximum number of the memory regions in the plan after merging and
+ * splitting */
+#ifndef CY_P64_ATTEST_MAX_REGIONS
+#define CY_P64_ATTEST_MAX_REGIONS           (8u)
+#endif /* CY_P64_ATTEST_MAX_REGIONS */
+
+/** The regions larger than this size are split, so one region hash does not
+ * cover the whole flash and a change is reported with a finer granularity */
+#ifndef CY_P64_ATTEST_REGION_MAX_SIZE
+#define CY_P64_ATTEST_REGION_MAX_SIZE       (0x40000u)
+#endif /* CY_P64_ATTEST_REGION_MAX_SIZE */
+
+/** The number of the region hashes kept by the cache */
+#ifndef CY_P64_ATTEST_CACHE_SIZE
+#define CY_P64_ATTEST_CACHE_SIZE            (8u)
+#endif /* CY_P64_ATTEST_CACHE_SIZE */
+
+/** The size of the region hash: SHA-256 */
+#define CY_P64_ATTEST_HASH_SIZE             (32u)
+
+/** The size of the device UID in the attestation response */
+#define CY_P64_ATTEST_UID_SIZE              (11u)
+
+/** The size of the binary attestation response: server and syscall random
+ * numbers, device UID, region count, regions (address, size, hash),
+ * signature size and signature */
+#define CY_P64_ATTEST_RESPONSE_RAW_SIZE(mem_count, hash_size, sign_size)       \
+    (8u + CY_P64_ATTEST_UID_SIZE + 4u + ((mem_count) * (8u + (hash_size))) + 4u + (sign_size))
+
+/** The buffer size for the base64 attestation response, including
+ * the terminating null character */
+#define CY_P64_ATTEST_RESPONSE_SIZE(mem_count, hash_size, sign_size)           \
+    (((((CY_P64_ATTEST_RESPONSE_RAW_SIZE((mem_count), (hash_size), (sign_size))) + 2u) / 3u) * 4u) + 1u)
+
+/** \} */
+
+/** \addtogroup attest_t
+ * \{
+ */
+
+/** The memory region requested for the attestation */
+typedef struct
+{
+    uint32_t start;                 /**< The start address */
+    uint32_t size;                  /**< The size in bytes */
+} cy_p64_attest_region_t;
+
+/** The planned memory region */
+typedef struct
+{
+    uint32_t start;                 /**< The start address */
+    uint32_t size;                  /**< The size in bytes */
+    bool changed;                   /**< The region was written or not attested since the last attestation */
+    bool reused;                    /**< The region is not hashed by the syscall, \ref hash holds the cached hash */
+    uint8_t hash[CY_P64_ATTEST_HASH_SIZE]; /**< The region hash after cy_p64_attest_run() */
+} cy_p64_attest_plan_region_t;
+
+/** The attestation plan */
+typedef struct
+{
+    uint32_t region_count;          /**< The number of the planned regions */
+    cy_p64_attest_plan_region_t regions[CY_P64_ATTEST_MAX_REGIONS]; /**< The planned regions sorted by address */
+    uint32_t mem_count;             /**< The number of the regions passed to cy_p64_attestation() */
+    uint32_t mem_start[CY_P64_ATTEST_MAX_REGIONS]; /**< The start addresses passed to cy_p64_attestation() */
+    uint32_t mem_size[CY_P64_ATTEST_MAX_REGIONS];  /**< The sizes passed to cy_p64_attestation() */
+    uint32_t mem_hash[(CY_P64_ATTEST_MAX_REGIONS * CY_P64_ATTEST_HASH_SIZE) / sizeof(uint32_t)]; /**< The hashes from cy_p64_attestation() */
+    uint32_t rnd_out;               /**< The syscall random number */
+    uint32_t sign_size;             /**< The size of the signature */
+    uint32_t sign_addr;             /**< The address of the signature */
+} cy_p64_attest_plan_t;
+
+/** The input of the attestation response builder, the output of
+ * cy_p64_attestation() */
+typedef struct
+{
+    uint32_t rnd;                   /**< The random number from the server */
+    uint32_t rnd_out;               /**< The random number from the syscall */
+    uint32_t mem_count;             /**< The number of the memory regions */
+    const uint32_t *mem_start;      /**< The start addresses of the regions */
+    const uint32_t *mem_size;       /**< The sizes of the regions */
+    const uint8_t *mem_hash;        /**< The region hashes, one after another */
+    uint32_t mem_hash_size;         /**< The size of each region hash */
+    const uint8_t *sign;            /**< The signature, sign_addr of cy_p64_attestation() */
+    uint32_t sign_size;             /**< The size of the signature */
+} cy_p64_attest_response_t;
+
+/** The output sink of the attestation response builder. It is called with
+ * the consecutive parts of the base64 response.
+ *
+ * \param data     The base64 characters, not null terminated.
+ * \param length   The number of the characters.
+ * \param arg      The user argument.
+ * \return         \ref CY_P64_SUCCESS to continue or error code to stop.
+ */
+typedef cy_p64_error_codes_t (*cy_p64_attest_sink_t)(const char *data, uint32_t length, void *arg);
+
+/** \} */
+
+/* Public APIs */
+void cy_p64_attest_flash_written(uint32_t address, uint32_t size);
+void cy_p64_attest_cache_clear(void);
+
+#ifndef CY_DEVICE_PSOC6A512K
+cy_p64_error_codes_t cy_p64_attest_plan(cy_p64_attest_plan_t *plan,
+                                        const cy_p64_attest_region_t *regions,
+                                        uint32_t count,
+                                        bool reuse_unchanged);
+cy_p64_error_codes_t cy_p64_attest_run(cy_p64_attest_plan_t *plan, uint32_t sign_alg, uint32_t rnd);
+cy_p64_error_codes_t cy_p64_attest_response_build(const cy_p64_attest_response_t *response,
+                                                  char *buffer,
+                                                  uint32_t buffer_size,
+                                                  uint32_t *length,
+                                                  cy_p64_attest_sink_t sink,
+                                                  void *sink_arg);
+#endif /* !CY_DEVICE_PSOC6A512K */
+
+#endif /* CY_P64_ATTEST_H */
@@ -61,6 +61,7 @@
 #include <stdbool.h>
 #include "cy_utils.h"
 #include "cy_p64_base64.h"
+#include "cy_p64_watchdog.h"
 
 
 /* C binding of definitions if building with C++ compiler */
@@ -75,6 +76,9 @@ extern "C" {
 #define BASE64_62_VALUE_BYTE( options ) ( (unsigned char)( (unsigned int)(options) >>  16 ) )
 #define BASE64_63_VALUE_BYTE( options ) ( (unsigned char)( (unsigned int)(options) >>   8 ) )
 
+/* The number of input characters decoded between two WDT heartbeats, a power of 2 */
+#define BASE64_HEARTBEAT_INTERVAL       ( 1024 )
+
 /* The array of base64 characters except for the last two, which depend on the conversion type */
 static const char base64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
 
@@ -285,6 +289,11 @@ int cy_p64_base64_decode( unsigned char const* src, int32_t src_length, unsigned
 
     while ( ( ( ch = *src++ ) != '\0' ) && ( ( src_length < 0 ) || ( (src - orig_src) <= src_length ) ) )
     {
+        if ( ( ( src - orig_src ) & ( BASE64_HEARTBEAT_INTERVAL - 1 ) ) == 0 )
+        {
+            cy_p64_wdg_heartbeat( );
+        }
+
         /* Skip whitespace anywhere. */
         if ( is_base64_space( ch ) != 0 )
         {
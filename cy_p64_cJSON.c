@@ -49,6 +49,7 @@
 #include <ctype.h>
 #include "cy_p64_cJSON.h"
 #include "cy_p64_malloc.h"
+#include "cy_p64_watchdog.h"
 
 #define DBL_EPSILON (1u)
 
@@ -898,6 +899,9 @@ static const unsigned  char *parse_value(cy_p64_cJSON * const item, const unsign
         return NULL; /* no input */
     }
 
+    /* Large policies take long to parse, keep the WDT alive */
+    cy_p64_wdg_heartbeat();
+
     /* Parse the different types of values */
     /* null */
     if (!strncmp((const char*)input, "null", 4))
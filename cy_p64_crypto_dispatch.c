@@ -0,0 +1,301 @@
+/***************************************************************************//**
+* \file cy_p64_crypto_dispatch.c
+* \version 1.0
+*
+* \brief
+* This is the source code file for the crypto dispatcher that runs public data
+* operations on the local Crypto HW.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+/*******************************************************************************
+* Crypto dispatcher Prototypes
+****************************************************************************//**
+*
+* \defgroup crypto_dispatch     Crypto dispatcher
+*
+* \brief
+*  This library runs the operations on public data (SHA-256 hashing of images
+*  and certificates, ECDSA verification with a public key) with the Crypto
+*  driver when the Crypto HW is accessible and enabled for the current core,
+*  see cy_p64_is_crypto_enabled(). It avoids the IPC and the Crypto HW hand-over
+*  of the Secure FlashBoot syscall. Otherwise, or if the Crypto driver fails,
+*  the operation is done by the PSA crypto syscalls.
+*
+*  The operations with the secret keys are never dispatched, use the PSA crypto
+*  functions for them.
+*
+* \note The application is responsible for serializing the Crypto driver usage
+*  with the other Crypto driver clients.
+*
+* \{
+*   \defgroup crypto_dispatch_api Functions
+*   \defgroup crypto_dispatch_macros Macros
+* \}
+*******************************************************************************/
+
+#include <string.h>
+#include "cy_crypto_common.h"
+#include "cy_crypto_core.h"
+#include "cy_p64_crypto_dispatch.h"
+#include "cy_p64_syscall.h"
+
+#if (CY_P64_DISPATCH_LOCAL_SHA256 != 0) && defined(CY_IP_MXCRYPTO) && defined(CY_CRYPTO_CFG_SHA2_256_ENABLED)
+    #define CY_P64_DISPATCH_SHA256_HW       (1)
+#else
+    #define CY_P64_DISPATCH_SHA256_HW       (0)
+#endif
+
+#if (CY_P64_DISPATCH_LOCAL_ECDSA != 0) && defined(CY_IP_MXCRYPTO) && \
+    defined(CY_CRYPTO_CFG_ECDSA_C) && defined(CY_CRYPTO_CFG_ECP_DP_SECP256R1_ENABLED)
+    #define CY_P64_DISPATCH_ECDSA_HW        (1)
+#else
+    #define CY_P64_DISPATCH_ECDSA_HW        (0)
+#endif
+
+/** The size of secp256r1 coordinate and signature component */
+#define CY_P64_DISPATCH_P256_SIZE           (32u)
+/** The size of the uncompressed secp256r1 public key: 0x04 | X | Y */
+#define CY_P64_DISPATCH_P256_PUB_KEY_SIZE   ((2u * CY_P64_DISPATCH_P256_SIZE) + 1u)
+/** The first byte of the uncompressed public key */
+#define CY_P64_DISPATCH_PUB_KEY_UNCOMPRESSED (0x04u)
+/** The size of the SHA-256 hash */
+#define CY_P64_DISPATCH_SHA256_SIZE         (32u)
+
+
+#if (CY_P64_DISPATCH_ECDSA_HW != 0)
+/*******************************************************************************
+* Function Name: cy_p64_dispatch_reverse_copy
+****************************************************************************//**
+* Copies the big-endian number used by PSA crypto to the little-endian buffer
+* used by the Crypto driver.
+*
+* \param[out] dst       The destination buffer.
+* \param[in] src        The source buffer.
+* \param[in] size       The size of the number in bytes.
+*******************************************************************************/
+static void cy_p64_dispatch_reverse_copy(uint8_t *dst, const uint8_t *src, uint32_t size)
+{
+    uint32_t i;
+
+    for(i = 0u; i < size; i++)
+    {
+        dst[i] = src[size - 1u - i];
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_dispatch_ecdsa_local
+****************************************************************************//**
+* Verifies the secp256r1 ECDSA signature with the Crypto driver.
+*
+* \param[in] pub_key            The uncompressed public key (0x04 | X | Y).
+* \param[in] hash               The hash whose signature is to be verified.
+* \param[in] hash_length        The size of the \p hash buffer in bytes.
+* \param[in] signature          The signature in PSA format (r | s).
+* \param[out] status            The verification status.
+* \return   true if the Crypto driver completed the operation, false if
+*           the operation must be done by the syscall.
+*******************************************************************************/
+static bool cy_p64_dispatch_ecdsa_local(const uint8_t *pub_key,
+                                        const uint8_t *hash,
+                                        size_t hash_length,
+                                        const uint8_t *signature,
+                                        cy_p64_psa_status_t *status)
+{
+    bool done = false;
+    uint8_t stat = 0u;
+    uint8_t sig[2u * CY_P64_DISPATCH_P256_SIZE];
+    uint8_t pub_x[CY_P64_DISPATCH_P256_SIZE];
+    uint8_t pub_y[CY_P64_DISPATCH_P256_SIZE];
+    cy_stc_crypto_ecc_key key;
+
+    cy_p64_dispatch_reverse_copy(sig, signature, CY_P64_DISPATCH_P256_SIZE);
+    cy_p64_dispatch_reverse_copy(&sig[CY_P64_DISPATCH_P256_SIZE],
+                                 &signature[CY_P64_DISPATCH_P256_SIZE], CY_P64_DISPATCH_P256_SIZE);
+    cy_p64_dispatch_reverse_copy(pub_x, &pub_key[1], CY_P64_DISPATCH_P256_SIZE);
+    cy_p64_dispatch_reverse_copy(pub_y, &pub_key[1u + CY_P64_DISPATCH_P256_SIZE], CY_P64_DISPATCH_P256_SIZE);
+
+    (void)memset(&key, 0, sizeof(key));
+    key.type = PK_PUBLIC;
+    key.curveID = CY_CRYPTO_ECC_ECP_SECP256R1;
+    key.pubkey.x = pub_x;
+    key.pubkey.y = pub_y;
+
+    if(Cy_Crypto_Core_ECC_VerifyHash(CRYPTO, sig, hash, (uint32_t)hash_length, &stat, &key) == CY_CRYPTO_SUCCESS)
+    {
+        *status = (stat == 1u) ? CY_P64_PSA_SUCCESS : CY_P64_PSA_ERROR_INVALID_SIGNATURE;
+        done = true;
+    }
+
+    return done;
+}
+#endif /* CY_P64_DISPATCH_ECDSA_HW != 0 */
+
+
+/*******************************************************************************
+* Function Prototypes
+****************************************************************************//**
+*
+*  \addtogroup crypto_dispatch_api
+*
+*  \{
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: cy_p64_dispatch_hash_compute
+****************************************************************************//**
+* Calculates the hash of a message in one call. SHA-256 is calculated by the
+* Crypto driver when the Crypto HW is available, other algorithms and the
+* fallback use cy_p64_psa_hash_setup(), cy_p64_psa_hash_update() and
+* cy_p64_psa_hash_finish().
+*
+* \note Use this function for the public data only.
+*
+* \param[in] alg            The hash algorithm.
+* \param[in] input          The message to hash.
+* \param[in] input_length   The size of the \p input buffer in bytes.
+* \param[out] hash          The buffer for the calculated hash.
+* \param[in] hash_size      The size of the \p hash buffer in bytes.
+* \param[out] hash_length   The number of bytes written to \p hash.
+*
+* \retval #CY_P64_PSA_SUCCESS
+* \retval #CY_P64_PSA_ERROR_INVALID_ARGUMENT
+* \retval #CY_P64_PSA_ERROR_NOT_SUPPORTED
+* \retval #CY_P64_PSA_ERROR_BUFFER_TOO_SMALL
+*******************************************************************************/
+cy_p64_psa_status_t cy_p64_dispatch_hash_compute(cy_p64_psa_algorithm_t alg,
+                                                 const uint8_t *input,
+                                                 size_t input_length,
+                                                 uint8_t *hash,
+                                                 size_t hash_size,
+                                                 size_t *hash_length)
+{
+    cy_p64_psa_status_t status = CY_P64_PSA_ERROR_NOT_SUPPORTED;
+    bool done = false;
+
+    if((hash == NULL) || (hash_length == NULL) || ((input == NULL) && (input_length != 0u)))
+    {
+        status = CY_P64_PSA_ERROR_INVALID_ARGUMENT;
+        done = true;
+    }
+#if (CY_P64_DISPATCH_SHA256_HW != 0)
+    else if((alg == CY_P64_PSA_ALG_SHA_256) && (hash_size >= CY_P64_DISPATCH_SHA256_SIZE) &&
+            cy_p64_is_crypto_enabled())
+    {
+        if(Cy_Crypto_Core_Sha(CRYPTO, input, (uint32_t)input_length, hash, CY_CRYPTO_MODE_SHA256) == CY_CRYPTO_SUCCESS)
+        {
+            *hash_length = CY_P64_DISPATCH_SHA256_SIZE;
+            status = CY_P64_PSA_SUCCESS;
+            done = true;
+        }
+    }
+#endif /* CY_P64_DISPATCH_SHA256_HW != 0 */
+    else
+    {
+        /* Done by the syscall below */
+    }
+
+    if(!done)
+    {
+        cy_p64_psa_hash_operation_t operation = CY_P64_PSA_HASH_OPERATION_INIT;
+
+        status = cy_p64_psa_hash_setup(&operation, alg);
+        if((status == CY_P64_PSA_SUCCESS) && (input_length != 0u))
+        {
+            status = cy_p64_psa_hash_update(&operation, input, input_length);
+        }
+        if(status == CY_P64_PSA_SUCCESS)
+        {
+            status = cy_p64_psa_hash_finish(&operation, hash, hash_size, hash_length);
+        }
+    }
+
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_dispatch_verify_hash
+****************************************************************************//**
+* Verifies the signature of a hash with a public key given in the export format
+* of cy_p64_psa_export_public_key(). The secp256r1 ECDSA signature is verified
+* by the Crypto driver when the Crypto HW is available, otherwise the key is
+* imported with cy_p64_psa_import_key() and verified by cy_p64_psa_verify_hash().
+*
+* \param[in] pub_key            The public key, uncompressed ECC point (0x04 | X | Y).
+* \param[in] pub_key_length     The size of the \p pub_key buffer in bytes.
+* \param[in] alg                The signature algorithm, e.g.
+*                               CY_P64_PSA_ALG_ECDSA(CY_P64_PSA_ALG_SHA_256).
+* \param[in] hash               The hash whose signature is to be verified.
+* \param[in] hash_length        The size of the \p hash buffer in bytes.
+* \param[in] signature          The buffer containing the signature to verify.
+* \param[in] signature_length   The size of the \p signature buffer in bytes.
+*
+* \retval #CY_P64_PSA_SUCCESS
+*         The signature is valid.
+* \retval #CY_P64_PSA_ERROR_INVALID_SIGNATURE
+* \retval #CY_P64_PSA_ERROR_INVALID_ARGUMENT
+* \retval #CY_P64_PSA_ERROR_NOT_SUPPORTED
+*******************************************************************************/
+cy_p64_psa_status_t cy_p64_dispatch_verify_hash(const uint8_t *pub_key,
+                                                size_t pub_key_length,
+                                                cy_p64_psa_algorithm_t alg,
+                                                const uint8_t *hash,
+                                                size_t hash_length,
+                                                const uint8_t *signature,
+                                                size_t signature_length)
+{
+    cy_p64_psa_status_t status = CY_P64_PSA_ERROR_NOT_SUPPORTED;
+    bool done = false;
+
+    if((pub_key == NULL) || (pub_key_length == 0u) || (hash == NULL) || (signature == NULL))
+    {
+        status = CY_P64_PSA_ERROR_INVALID_ARGUMENT;
+        done = true;
+    }
+#if (CY_P64_DISPATCH_ECDSA_HW != 0)
+    else if(CY_P64_PSA_ALG_IS_ECDSA(alg) &&
+            (pub_key_length == CY_P64_DISPATCH_P256_PUB_KEY_SIZE) &&
+            (pub_key[0] == CY_P64_DISPATCH_PUB_KEY_UNCOMPRESSED) &&
+            (signature_length == (2u * CY_P64_DISPATCH_P256_SIZE)) &&
+            cy_p64_is_crypto_enabled())
+    {
+        done = cy_p64_dispatch_ecdsa_local(pub_key, hash, hash_length, signature, &status);
+    }
+#endif /* CY_P64_DISPATCH_ECDSA_HW != 0 */
+    else
+    {
+        /* Done by the syscall below */
+    }
+
+    if(!done)
+    {
+        cy_p64_psa_key_attributes_t attributes = CY_P64_PSA_KEY_ATTRIBUTES_INIT;
+        cy_p64_psa_key_handle_t handle = 0u;
+
+        cy_p64_psa_set_key_type(&attributes, CY_P64_PSA_KEY_TYPE_ECC_PUBLIC_KEY(CY_P64_PSA_ECC_FAMILY_SECP_R1));
+        cy_p64_psa_set_key_bits(&attributes, CY_P64_PSA_BYTES_TO_BITS((pub_key_length - 1u) / 2u));
+        cy_p64_psa_set_key_algorithm(&attributes, alg);
+        cy_p64_psa_set_key_usage_flags(&attributes, CY_P64_PSA_KEY_USAGE_VERIFY_HASH);
+
+        status = cy_p64_psa_import_key(&attributes, pub_key, pub_key_length, &handle);
+        if(status == CY_P64_PSA_SUCCESS)
+        {
+            status = cy_p64_psa_verify_hash(handle, alg, hash, hash_length, signature, signature_length);
+            (void)cy_p64_psa_destroy_key(handle);
+        }
+    }
+
+    return status;
+}
+
+/** \} */
@@ -0,0 +1,56 @@
+/***************************************************************************//**
+* \file cy_p64_crypto_dispatch.h
+* \version 1.0
+*
+* \brief
+* This is the header file for the crypto dispatcher that runs public data
+* operations on the local Crypto HW.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef CY_P64_CRYPTO_DISPATCH_H
+#define CY_P64_CRYPTO_DISPATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "cy_p64_psacrypto.h"
+
+/** \addtogroup crypto_dispatch_macros
+ * \{
+ */
+
+/** Set to 0 to always calculate SHA-256 by the Secure FlashBoot syscalls */
+#ifndef CY_P64_DISPATCH_LOCAL_SHA256
+#define CY_P64_DISPATCH_LOCAL_SHA256        (1)
+#endif /* CY_P64_DISPATCH_LOCAL_SHA256 */
+
+/** Set to 0 to always verify ECDSA signatures by the Secure FlashBoot syscalls */
+#ifndef CY_P64_DISPATCH_LOCAL_ECDSA
+#define CY_P64_DISPATCH_LOCAL_ECDSA         (1)
+#endif /* CY_P64_DISPATCH_LOCAL_ECDSA */
+
+/** \} */
+
+/* Public APIs */
+cy_p64_psa_status_t cy_p64_dispatch_hash_compute(cy_p64_psa_algorithm_t alg,
+                                                 const uint8_t *input,
+                                                 size_t input_length,
+                                                 uint8_t *hash,
+                                                 size_t hash_size,
+                                                 size_t *hash_length);
+cy_p64_psa_status_t cy_p64_dispatch_verify_hash(const uint8_t *pub_key,
+                                                size_t pub_key_length,
+                                                cy_p64_psa_algorithm_t alg,
+                                                const uint8_t *hash,
+                                                size_t hash_length,
+                                                const uint8_t *signature,
+                                                size_t signature_length);
+
+#endif /* CY_P64_CRYPTO_DISPATCH_H */
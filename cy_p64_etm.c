@@ -0,0 +1,522 @@
+/***************************************************************************//**
+* \file cy_p64_etm.c
+* \version 1.0
+*
+* \brief
+* This is the source code file for the encrypt-then-MAC authenticated
+* decryption functions.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+/*******************************************************************************
+* Encrypt-then-MAC Prototypes
+****************************************************************************//**
+*
+* \defgroup etm     Encrypt-then-MAC decryption
+*
+* \brief
+*  Secure FlashBoot provides the cipher decryption and the MAC verification
+*  only as separate operations. This library combines them in the
+*  encrypt-then-MAC construction: each ciphertext chunk is passed to
+*  cy_p64_psa_mac_update() and cy_p64_psa_cipher_update() one after another,
+*  so the data is read only once.
+*
+*  The MAC is calculated over the additional data (e.g. the header with IV)
+*  followed by the ciphertext. The plaintext is written to the buffer given
+*  to cy_p64_etm_decrypt_setup(), but it is released only by a successful
+*  cy_p64_etm_decrypt_finish(), which returns the plaintext length. When the
+*  MAC verification or any other step fails, the plaintext buffer is cleared.
+*  The whole plaintext is kept in this RAM buffer, so its size limits the
+*  size of the data.
+*
+*  Larger data, e.g. an encrypted image, is decrypted with
+*  cy_p64_etm_decrypt_setup_sink(): each plaintext chunk is passed to the
+*  sink, which stores it in a staging area that is not used yet (e.g. the
+*  upgrade slot without the trailer). The staging area is released by the
+*  successful cy_p64_etm_decrypt_finish(), otherwise the sink erases it.
+*
+* \{
+*   \defgroup etm_api Functions
+*   \defgroup etm_macros Macros
+*   \defgroup etm_t Data Structures
+* \}
+*******************************************************************************/
+
+#include <string.h>
+#include "cy_p64_etm.h"
+
+/* The largest block of the supported block ciphers */
+#define CY_P64_ETM_BLOCK_MAX_SIZE           (16u)
+
+
+/*******************************************************************************
+* Function Name: cy_p64_etm_release
+****************************************************************************//**
+* Finishes the cipher and the MAC operations to free them in Secure FlashBoot.
+* There is no abort syscall for these operations, the results are discarded.
+*******************************************************************************/
+static void cy_p64_etm_release(cy_p64_etm_decrypt_t *ctx)
+{
+    uint8_t scratch[CY_P64_ETM_BLOCK_MAX_SIZE];
+    size_t length = 0u;
+
+    (void)cy_p64_psa_cipher_finish(&ctx->cipher, scratch, sizeof(scratch), &length);
+    (void)cy_p64_psa_mac_verify_finish(&ctx->mac, scratch, 0u);
+    (void)memset(scratch, 0, sizeof(scratch));
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_etm_push
+****************************************************************************//**
+* Passes the decrypted bytes in the chunk buffer to the sink and clears the
+* buffer. Does nothing without the sink.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_etm_push(cy_p64_etm_decrypt_t *ctx)
+{
+    cy_p64_psa_status_t status = CY_P64_PSA_SUCCESS;
+
+    if((ctx->sink != NULL) && (ctx->output_length > 0u))
+    {
+        status = ctx->sink->write(ctx->output, ctx->output_length, ctx->sink->arg);
+        (void)memset(ctx->output, 0, ctx->output_length);
+        ctx->sink_length += ctx->output_length;
+        ctx->output_length = 0u;
+    }
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_etm_clear
+****************************************************************************//**
+* Clears the withheld plaintext, erases the plaintext passed to the sink and
+* resets the context.
+*******************************************************************************/
+static void cy_p64_etm_clear(cy_p64_etm_decrypt_t *ctx)
+{
+    if(ctx->output != NULL)
+    {
+        (void)memset(ctx->output, 0, ctx->output_length);
+    }
+    if((ctx->sink != NULL) && (ctx->sink->discard != NULL))
+    {
+        ctx->sink->discard(ctx->sink->arg);
+    }
+    ctx->sink = NULL;
+    ctx->sink_length = 0u;
+    ctx->output_length = 0u;
+    ctx->active = false;
+    ctx->data_started = false;
+}
+
+
+/*******************************************************************************
+* Function Prototypes
+****************************************************************************//**
+*
+*  \addtogroup etm_api
+*
+*  \{
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: cy_p64_etm_decrypt_setup
+****************************************************************************//**
+* Sets up the cipher decryption and the MAC verification operations. The whole
+* plaintext is written to \p output, use cy_p64_etm_decrypt_setup_sink() for
+* the data larger than the available RAM.
+*
+* \param[out] ctx           The decryption context.
+* \param[in] cipher_key     The cipher key handle.
+* \param[in] cipher_alg     The cipher algorithm, e.g. CY_P64_PSA_ALG_CTR.
+* \param[in] iv             The IV.
+* \param[in] iv_length      The IV length.
+* \param[in] mac_key        The MAC key handle.
+* \param[in] mac_alg        The MAC algorithm, e.g.
+*                           CY_P64_PSA_ALG_HMAC(CY_P64_PSA_ALG_SHA_256).
+* \param[out] output        The plaintext buffer.
+* \param[in] output_size    The size of the plaintext buffer.
+* \return     \ref CY_P64_PSA_SUCCESS for success or the error code.
+*******************************************************************************/
+cy_p64_psa_status_t cy_p64_etm_decrypt_setup(cy_p64_etm_decrypt_t *ctx,
+                                             cy_p64_psa_key_handle_t cipher_key,
+                                             cy_p64_psa_algorithm_t cipher_alg,
+                                             const uint8_t *iv,
+                                             size_t iv_length,
+                                             cy_p64_psa_key_handle_t mac_key,
+                                             cy_p64_psa_algorithm_t mac_alg,
+                                             uint8_t *output,
+                                             size_t output_size)
+{
+    cy_p64_psa_status_t status;
+
+    if((ctx == NULL) || (output == NULL))
+    {
+        status = CY_P64_PSA_ERROR_INVALID_ARGUMENT;
+    }
+    else
+    {
+        (void)memset(ctx, 0, sizeof(*ctx));
+        ctx->output = output;
+        ctx->output_size = output_size;
+
+        status = cy_p64_psa_mac_verify_setup(&ctx->mac, mac_key, mac_alg);
+        if(status == CY_P64_PSA_SUCCESS)
+        {
+            status = cy_p64_psa_cipher_decrypt_setup(&ctx->cipher, cipher_key, cipher_alg);
+            if(status == CY_P64_PSA_SUCCESS)
+            {
+                ctx->active = true;
+                status = cy_p64_psa_cipher_set_iv(&ctx->cipher, iv, iv_length);
+            }
+            else
+            {
+                (void)cy_p64_psa_mac_verify_finish(&ctx->mac, output, 0u);
+            }
+        }
+
+        if((status != CY_P64_PSA_SUCCESS) && ctx->active)
+        {
+            cy_p64_etm_decrypt_abort(ctx);
+        }
+    }
+
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_etm_decrypt_setup_sink
+****************************************************************************//**
+* Sets up the decryption to the sink: the plaintext of each ciphertext chunk
+* is decrypted to \p buffer and passed to cy_p64_etm_sink_t::write, so the
+* data of any size is decrypted with the constant RAM. The sink stores the
+* plaintext in a staging area which is not used until the MAC is verified.
+* When the MAC verification or any other step fails, or the decryption is
+* aborted, cy_p64_etm_sink_t::discard is called to erase the staging area.
+*
+* \param[out] ctx           The decryption context.
+* \param[in] cipher_key     The cipher key handle.
+* \param[in] cipher_alg     The cipher algorithm, e.g. CY_P64_PSA_ALG_CTR.
+* \param[in] iv             The IV.
+* \param[in] iv_length      The IV length.
+* \param[in] mac_key        The MAC key handle.
+* \param[in] mac_alg        The MAC algorithm, e.g.
+*                           CY_P64_PSA_ALG_HMAC(CY_P64_PSA_ALG_SHA_256).
+* \param[in] sink           The plaintext sink, must be valid until the
+*                           decryption is finished or aborted.
+* \param[out] buffer        The chunk buffer, the longer ciphertext chunks are
+*                           decrypted by parts.
+* \param[in] buffer_size    The size of the chunk buffer, must be larger than
+*                           the cipher block.
+* \return     \ref CY_P64_PSA_SUCCESS for success or the error code.
+*******************************************************************************/
+cy_p64_psa_status_t cy_p64_etm_decrypt_setup_sink(cy_p64_etm_decrypt_t *ctx,
+                                                  cy_p64_psa_key_handle_t cipher_key,
+                                                  cy_p64_psa_algorithm_t cipher_alg,
+                                                  const uint8_t *iv,
+                                                  size_t iv_length,
+                                                  cy_p64_psa_key_handle_t mac_key,
+                                                  cy_p64_psa_algorithm_t mac_alg,
+                                                  const cy_p64_etm_sink_t *sink,
+                                                  uint8_t *buffer,
+                                                  size_t buffer_size)
+{
+    cy_p64_psa_status_t status;
+
+    if((sink == NULL) || (sink->write == NULL) || (buffer_size <= CY_P64_ETM_BLOCK_MAX_SIZE))
+    {
+        status = CY_P64_PSA_ERROR_INVALID_ARGUMENT;
+    }
+    else
+    {
+        status = cy_p64_etm_decrypt_setup(ctx, cipher_key, cipher_alg, iv, iv_length,
+                                          mac_key, mac_alg, buffer, buffer_size);
+        if(status == CY_P64_PSA_SUCCESS)
+        {
+            ctx->sink = sink;
+        }
+    }
+
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_etm_decrypt_update_ad
+****************************************************************************//**
+* Passes the additional data to the MAC. The additional data must be passed
+* before the ciphertext.
+*
+* \param[in] ctx            The decryption context.
+* \param[in] input          The additional data.
+* \param[in] input_length   The length of the additional data.
+* \return     \ref CY_P64_PSA_SUCCESS for success or the error code.
+*            The context is aborted on error.
+*******************************************************************************/
+cy_p64_psa_status_t cy_p64_etm_decrypt_update_ad(cy_p64_etm_decrypt_t *ctx,
+                                                 const uint8_t *input,
+                                                 size_t input_length)
+{
+    cy_p64_psa_status_t status;
+
+    if((ctx == NULL) || (!ctx->active) || ctx->data_started)
+    {
+        status = CY_P64_PSA_ERROR_BAD_STATE;
+    }
+    else
+    {
+        status = cy_p64_psa_mac_update(&ctx->mac, input, input_length);
+        if(status != CY_P64_PSA_SUCCESS)
+        {
+            cy_p64_etm_decrypt_abort(ctx);
+        }
+    }
+
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_etm_decrypt_update
+****************************************************************************//**
+* Authenticates and decrypts the ciphertext chunk. The plaintext is appended
+* to the plaintext buffer and withheld until cy_p64_etm_decrypt_finish(), or
+* passed to the sink set by cy_p64_etm_decrypt_setup_sink().
+*
+* \param[in] ctx            The decryption context.
+* \param[in] input          The ciphertext chunk.
+* \param[in] input_length   The length of the chunk.
+* \return     \ref CY_P64_PSA_SUCCESS for success or the error code.
+*            The context is aborted on error.
+*******************************************************************************/
+cy_p64_psa_status_t cy_p64_etm_decrypt_update(cy_p64_etm_decrypt_t *ctx,
+                                              const uint8_t *input,
+                                              size_t input_length)
+{
+    cy_p64_psa_status_t status;
+    size_t length = 0u;
+    size_t offset = 0u;
+    size_t part;
+
+    if((ctx == NULL) || (!ctx->active))
+    {
+        status = CY_P64_PSA_ERROR_BAD_STATE;
+    }
+    else
+    {
+        ctx->data_started = true;
+
+        status = cy_p64_psa_mac_update(&ctx->mac, input, input_length);
+        while((status == CY_P64_PSA_SUCCESS) && (offset < input_length))
+        {
+            part = input_length - offset;
+            /* The chunk buffer takes the part and the block held by the cipher */
+            if((ctx->sink != NULL) && (part > (ctx->output_size - CY_P64_ETM_BLOCK_MAX_SIZE)))
+            {
+                part = ctx->output_size - CY_P64_ETM_BLOCK_MAX_SIZE;
+            }
+            status = cy_p64_psa_cipher_update(&ctx->cipher, &input[offset], part,
+                                              &ctx->output[ctx->output_length],
+                                              ctx->output_size - ctx->output_length, &length);
+            if(status == CY_P64_PSA_SUCCESS)
+            {
+                ctx->output_length += length;
+                status = cy_p64_etm_push(ctx);
+            }
+            offset += part;
+        }
+        if(status != CY_P64_PSA_SUCCESS)
+        {
+            cy_p64_etm_decrypt_abort(ctx);
+        }
+    }
+
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_etm_decrypt_finish
+****************************************************************************//**
+* Finishes the decryption and verifies the MAC. The plaintext is released
+* only when the MAC is correct, otherwise the plaintext buffer is cleared and
+* the plaintext passed to the sink is discarded.
+*
+* \param[in] ctx            The decryption context.
+* \param[in] mac            The expected MAC.
+* \param[in] mac_length     The length of the expected MAC.
+* \param[out] output_length The length of the plaintext, with the sink the
+*                           total length passed to the sink, 0 on error.
+* \return     \ref CY_P64_PSA_SUCCESS for success,
+*             \ref CY_P64_PSA_ERROR_INVALID_SIGNATURE if the MAC is wrong
+*             or other error code.
+*******************************************************************************/
+cy_p64_psa_status_t cy_p64_etm_decrypt_finish(cy_p64_etm_decrypt_t *ctx,
+                                              const uint8_t *mac,
+                                              size_t mac_length,
+                                              size_t *output_length)
+{
+    cy_p64_psa_status_t status;
+    cy_p64_psa_status_t mac_status;
+    size_t length = 0u;
+
+    if(output_length == NULL)
+    {
+        status = CY_P64_PSA_ERROR_INVALID_ARGUMENT;
+    }
+    else if((ctx == NULL) || (!ctx->active))
+    {
+        *output_length = 0u;
+        status = CY_P64_PSA_ERROR_BAD_STATE;
+    }
+    else
+    {
+        status = cy_p64_psa_cipher_finish(&ctx->cipher, &ctx->output[ctx->output_length],
+                                          ctx->output_size - ctx->output_length, &length);
+        ctx->output_length += length;
+        if(status == CY_P64_PSA_SUCCESS)
+        {
+            status = cy_p64_etm_push(ctx);
+        }
+
+        /* The MAC operation is finished in any case to free it */
+        mac_status = cy_p64_psa_mac_verify_finish(&ctx->mac, mac, mac_length);
+        if(status == CY_P64_PSA_SUCCESS)
+        {
+            status = mac_status;
+        }
+
+        if(status == CY_P64_PSA_SUCCESS)
+        {
+            if(ctx->sink != NULL)
+            {
+                *output_length = ctx->sink_length;
+                /* The staged plaintext is released, nothing to discard */
+                ctx->sink = NULL;
+            }
+            else
+            {
+                *output_length = ctx->output_length;
+            }
+            ctx->active = false;
+        }
+        else
+        {
+            *output_length = 0u;
+            cy_p64_etm_clear(ctx);
+        }
+    }
+
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_etm_decrypt_abort
+****************************************************************************//**
+* Aborts the decryption, clears the withheld plaintext and discards the
+* plaintext passed to the sink.
+*
+* \param[in] ctx            The decryption context.
+*******************************************************************************/
+void cy_p64_etm_decrypt_abort(cy_p64_etm_decrypt_t *ctx)
+{
+    if(ctx != NULL)
+    {
+        if(ctx->active)
+        {
+            cy_p64_etm_release(ctx);
+        }
+        cy_p64_etm_clear(ctx);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_etm_decrypt
+****************************************************************************//**
+* Authenticates and decrypts the memory mapped ciphertext (e.g. in the flash)
+* in one pass, by chunks of \ref CY_P64_ETM_CHUNK_SIZE bytes. The whole
+* plaintext is written to \p output in RAM, decrypt the larger data with
+* cy_p64_etm_decrypt_setup_sink().
+*
+* \param[in] cipher_key     The cipher key handle.
+* \param[in] cipher_alg     The cipher algorithm.
+* \param[in] iv             The IV.
+* \param[in] iv_length      The IV length.
+* \param[in] mac_key        The MAC key handle.
+* \param[in] mac_alg        The MAC algorithm.
+* \param[in] ad             The additional data or NULL.
+* \param[in] ad_length      The length of the additional data.
+* \param[in] input          The ciphertext.
+* \param[in] input_length   The length of the ciphertext.
+* \param[in] mac            The expected MAC.
+* \param[in] mac_length     The length of the expected MAC.
+* \param[out] output        The plaintext buffer.
+* \param[in] output_size    The size of the plaintext buffer.
+* \param[out] output_length The length of the plaintext, 0 on error.
+* \return     \ref CY_P64_PSA_SUCCESS for success or the error code.
+*******************************************************************************/
+cy_p64_psa_status_t cy_p64_etm_decrypt(cy_p64_psa_key_handle_t cipher_key,
+                                       cy_p64_psa_algorithm_t cipher_alg,
+                                       const uint8_t *iv,
+                                       size_t iv_length,
+                                       cy_p64_psa_key_handle_t mac_key,
+                                       cy_p64_psa_algorithm_t mac_alg,
+                                       const uint8_t *ad,
+                                       size_t ad_length,
+                                       const uint8_t *input,
+                                       size_t input_length,
+                                       const uint8_t *mac,
+                                       size_t mac_length,
+                                       uint8_t *output,
+                                       size_t output_size,
+                                       size_t *output_length)
+{
+    cy_p64_psa_status_t status;
+    cy_p64_etm_decrypt_t ctx;
+    size_t offset = 0u;
+    size_t chunk;
+
+    status = cy_p64_etm_decrypt_setup(&ctx, cipher_key, cipher_alg, iv, iv_length,
+                                      mac_key, mac_alg, output, output_size);
+    if((status == CY_P64_PSA_SUCCESS) && (ad != NULL) && (ad_length > 0u))
+    {
+        status = cy_p64_etm_decrypt_update_ad(&ctx, ad, ad_length);
+    }
+    while((status == CY_P64_PSA_SUCCESS) && (offset < input_length))
+    {
+        chunk = input_length - offset;
+        if(chunk > CY_P64_ETM_CHUNK_SIZE)
+        {
+            chunk = CY_P64_ETM_CHUNK_SIZE;
+        }
+        status = cy_p64_etm_decrypt_update(&ctx, &input[offset], chunk);
+        offset += chunk;
+    }
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_etm_decrypt_finish(&ctx, mac, mac_length, output_length);
+    }
+    else if(output_length != NULL)
+    {
+        *output_length = 0u;
+    }
+    else
+    {
+        /* No output length to report */
+    }
+
+    return status;
+}
+
+/** \} */
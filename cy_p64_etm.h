@@ -0,0 +1,132 @@
+/***************************************************************************//**
+* \file cy_p64_etm.h
+* \version 1.0
+*
+* \brief
+* This is the header file for the encrypt-then-MAC authenticated decryption
+* functions.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef CY_P64_ETM_H
+#define CY_P64_ETM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "cy_p64_psacrypto.h"
+
+/** \addtogroup etm_macros
+ * \{
+ */
+
+/** The size of the chunk passed to the MAC and the cipher by
+ * cy_p64_etm_decrypt(). Must be a multiple of the cipher block size. */
+#ifndef CY_P64_ETM_CHUNK_SIZE
+#define CY_P64_ETM_CHUNK_SIZE               (0x1000u)
+#endif /* CY_P64_ETM_CHUNK_SIZE */
+
+/** \} */
+
+/** \addtogroup etm_t
+ * \{
+ */
+
+/** Stores the next plaintext chunk in the staging area, e.g. with
+ * cy_p64_image_upgrade_write() to the upgrade slot that is not confirmed yet.
+ *
+ * \param data        The plaintext chunk, cleared after the call.
+ * \param length      The length of the chunk.
+ * \param arg         The user argument of the sink.
+ * \return            \ref CY_P64_PSA_SUCCESS or the error code, which aborts
+ *                    the decryption.
+ */
+typedef cy_p64_psa_status_t (*cy_p64_etm_write_cb_t)(const uint8_t *data, size_t length, void *arg);
+
+/** Erases the staged plaintext when the MAC verification or any other step
+ * fails, or the decryption is aborted.
+ *
+ * \param arg         The user argument of the sink.
+ */
+typedef void (*cy_p64_etm_discard_cb_t)(void *arg);
+
+/** The plaintext sink of cy_p64_etm_decrypt_setup_sink() */
+typedef struct
+{
+    cy_p64_etm_write_cb_t write;            /**< Stores the plaintext chunk */
+    cy_p64_etm_discard_cb_t discard;        /**< Erases the stored plaintext */
+    void *arg;                              /**< The user argument of the callbacks */
+} cy_p64_etm_sink_t;
+
+/** The authenticated decryption context */
+typedef struct
+{
+    cy_p64_psa_cipher_operation_t cipher;   /**< The cipher operation */
+    cy_p64_psa_mac_operation_t mac;         /**< The MAC verification operation */
+    uint8_t *output;                        /**< The plaintext buffer, the chunk buffer with the sink */
+    size_t output_size;                     /**< The size of the plaintext buffer */
+    size_t output_length;                   /**< The number of the decrypted bytes, not released yet */
+    const cy_p64_etm_sink_t *sink;          /**< The plaintext sink or NULL */
+    size_t sink_length;                     /**< The number of the bytes passed to the sink */
+    bool active;                            /**< The operations are set up */
+    bool data_started;                      /**< The ciphertext is passed, no more additional data */
+} cy_p64_etm_decrypt_t;
+
+/** \} */
+
+/* Public APIs */
+cy_p64_psa_status_t cy_p64_etm_decrypt_setup(cy_p64_etm_decrypt_t *ctx,
+                                             cy_p64_psa_key_handle_t cipher_key,
+                                             cy_p64_psa_algorithm_t cipher_alg,
+                                             const uint8_t *iv,
+                                             size_t iv_length,
+                                             cy_p64_psa_key_handle_t mac_key,
+                                             cy_p64_psa_algorithm_t mac_alg,
+                                             uint8_t *output,
+                                             size_t output_size);
+cy_p64_psa_status_t cy_p64_etm_decrypt_setup_sink(cy_p64_etm_decrypt_t *ctx,
+                                                  cy_p64_psa_key_handle_t cipher_key,
+                                                  cy_p64_psa_algorithm_t cipher_alg,
+                                                  const uint8_t *iv,
+                                                  size_t iv_length,
+                                                  cy_p64_psa_key_handle_t mac_key,
+                                                  cy_p64_psa_algorithm_t mac_alg,
+                                                  const cy_p64_etm_sink_t *sink,
+                                                  uint8_t *buffer,
+                                                  size_t buffer_size);
+cy_p64_psa_status_t cy_p64_etm_decrypt_update_ad(cy_p64_etm_decrypt_t *ctx,
+                                                 const uint8_t *input,
+                                                 size_t input_length);
+cy_p64_psa_status_t cy_p64_etm_decrypt_update(cy_p64_etm_decrypt_t *ctx,
+                                              const uint8_t *input,
+                                              size_t input_length);
+cy_p64_psa_status_t cy_p64_etm_decrypt_finish(cy_p64_etm_decrypt_t *ctx,
+                                              const uint8_t *mac,
+                                              size_t mac_length,
+                                              size_t *output_length);
+void cy_p64_etm_decrypt_abort(cy_p64_etm_decrypt_t *ctx);
+
+cy_p64_psa_status_t cy_p64_etm_decrypt(cy_p64_psa_key_handle_t cipher_key,
+                                       cy_p64_psa_algorithm_t cipher_alg,
+                                       const uint8_t *iv,
+                                       size_t iv_length,
+                                       cy_p64_psa_key_handle_t mac_key,
+                                       cy_p64_psa_algorithm_t mac_alg,
+                                       const uint8_t *ad,
+                                       size_t ad_length,
+                                       const uint8_t *input,
+                                       size_t input_length,
+                                       const uint8_t *mac,
+                                       size_t mac_length,
+                                       uint8_t *output,
+                                       size_t output_size,
+                                       size_t *output_length);
+
+#endif /* CY_P64_ETM_H */
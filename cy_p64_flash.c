@@ -0,0 +1,184 @@
+/***************************************************************************//**
+* \file cy_p64_flash.c
+* \version 1.0
+*
+* \brief
+* This is the source code file for the flash access functions.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+/*******************************************************************************
+* Flash Prototypes
+****************************************************************************//**
+*
+* \defgroup flash     Flash access
+*
+* \brief
+*  This library is the flash access layer of the image utilities. The
+*  functions in this file call the PDL flash driver. The host build defines
+*  CY_P64_FLASH_SIM and links the flash simulator from the host directory
+*  instead, which implements the same functions on a memory array and counts
+*  the erase and program operations, their time and the wear of each row.
+*
+*  The non-blocking functions return after the operation is started, poll
+*  cy_p64_flash_is_complete() until it returns "true" before the next
+*  operation.
+*
+* \{
+*   \defgroup flash_api Functions
+*   \defgroup flash_macros Macros
+*   \defgroup flash_t Data Structures
+* \}
+*******************************************************************************/
+
+#include "cy_p64_flash.h"
+
+#if !defined(CY_P64_FLASH_SIM)
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_status
+****************************************************************************//**
+* Converts the status of the PDL flash driver.
+*******************************************************************************/
+static cy_p64_error_codes_t cy_p64_flash_status(cy_en_flashdrv_status_t flash_status)
+{
+    cy_p64_error_codes_t ret = CY_P64_INVALID_FLASH_OPERATION;
+
+    if((flash_status == CY_FLASH_DRV_OPERATION_STARTED) || (flash_status == CY_FLASH_DRV_SUCCESS))
+    {
+        ret = CY_P64_SUCCESS;
+    }
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Prototypes
+****************************************************************************//**
+*
+*  \addtogroup flash_api
+*
+*  \{
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_write_row
+****************************************************************************//**
+* Erases and programs the flash row, returns when the operation is complete.
+*
+* \param[in] address        The row aligned flash address.
+* \param[in] data           The row data, \ref CY_P64_FLASH_ROW_SIZE bytes.
+* \return     \ref CY_P64_SUCCESS for success or error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_flash_write_row(uint32_t address, const uint32_t *data)
+{
+    cy_p64_error_codes_t ret = CY_P64_INVALID_FLASH_OPERATION;
+
+    if(Cy_Flash_WriteRow(address, data) == CY_FLASH_DRV_SUCCESS)
+    {
+        ret = CY_P64_SUCCESS;
+    }
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_start_write
+****************************************************************************//**
+* Starts erasing and programming the flash row.
+*
+* \param[in] address        The row aligned flash address.
+* \param[in] data           The row data, it must be valid until the operation
+*                           is complete.
+* \return     \ref CY_P64_SUCCESS if the operation is started or error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_flash_start_write(uint32_t address, const uint32_t *data)
+{
+    return cy_p64_flash_status(Cy_Flash_StartWrite(address, data));
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_start_program
+****************************************************************************//**
+* Starts programming the erased flash row.
+*
+* \param[in] address        The row aligned flash address.
+* \param[in] data           The row data, it must be valid until the operation
+*                           is complete.
+* \return     \ref CY_P64_SUCCESS if the operation is started or error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_flash_start_program(uint32_t address, const uint32_t *data)
+{
+    return cy_p64_flash_status(Cy_Flash_StartProgram(address, data));
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_start_erase
+****************************************************************************//**
+* Starts erasing the flash row or subsector.
+*
+* \param[in] address        The flash address aligned to \p size.
+* \param[in] size           \ref CY_P64_FLASH_ROW_SIZE or
+*                           \ref CY_P64_FLASH_SUBSECTOR_SIZE.
+* \return     \ref CY_P64_SUCCESS if the operation is started or error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_flash_start_erase(uint32_t address, uint32_t size)
+{
+    cy_p64_error_codes_t ret;
+
+    if(size == CY_P64_FLASH_SUBSECTOR_SIZE)
+    {
+        ret = cy_p64_flash_status(Cy_Flash_StartEraseSubsector(address));
+    }
+    else if(size == CY_P64_FLASH_ROW_SIZE)
+    {
+        ret = cy_p64_flash_status(Cy_Flash_StartEraseRow(address));
+    }
+    else
+    {
+        ret = CY_P64_INVALID_ARGUMENT;
+    }
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_is_complete
+****************************************************************************//**
+* Checks the non-blocking flash operation.
+*
+* \param[out] status        The result of the complete operation.
+* \return     "true" if the operation is complete, "false" if it is in progress.
+*******************************************************************************/
+bool cy_p64_flash_is_complete(cy_p64_error_codes_t *status)
+{
+    bool ret = true;
+    cy_en_flashdrv_status_t flash_status = Cy_Flash_IsOperationComplete();
+
+    if(flash_status == CY_FLASH_DRV_OPCODE_BUSY)
+    {
+        ret = false;
+    }
+    else if(status != NULL)
+    {
+        *status = (flash_status == CY_FLASH_DRV_SUCCESS) ? CY_P64_SUCCESS : CY_P64_INVALID_FLASH_OPERATION;
+    }
+    else
+    {
+        /* The status is not requested */
+    }
+    return ret;
+}
+
+/** \} */
+
+#endif /* !CY_P64_FLASH_SIM */
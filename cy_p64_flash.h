@@ -0,0 +1,61 @@
+/***************************************************************************//**
+* \file cy_p64_flash.h
+* \version 1.0
+*
+* \brief
+* This is the header file for the flash access functions.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef CY_P64_FLASH_H
+#define CY_P64_FLASH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_p64_syscall.h"
+#include "cy_flash.h"
+
+/** \addtogroup flash_macros
+ * \{
+ */
+
+/** The size of the flash row, the unit of programming */
+#define CY_P64_FLASH_ROW_SIZE               (CY_FLASH_SIZEOF_ROW)
+
+/** The size of the flash subsector (8 rows), the erase unit of
+ * cy_p64_flash_start_erase() next to the row */
+#define CY_P64_FLASH_SUBSECTOR_SIZE         (8u * CY_FLASH_SIZEOF_ROW)
+
+/** The size of the flash sector. The flash can be read while a row in another
+ * sector is programmed or erased (read-while-write), reading the same sector
+ * stalls or returns invalid data. */
+#ifndef CY_P64_FLASH_SECTOR_SIZE
+#define CY_P64_FLASH_SECTOR_SIZE            (0x40000u)
+#endif /* CY_P64_FLASH_SECTOR_SIZE */
+
+#if defined(CY_P64_FLASH_SIM)
+const uint8_t *cy_p64_flash_ptr(uint32_t address);
+#else
+/** Returns the pointer to read the flash at the address. The flash is memory
+ * mapped on the device, the host simulator translates the address to its
+ * memory array. */
+#define cy_p64_flash_ptr(address)           ((const uint8_t *)(address))
+#endif /* CY_P64_FLASH_SIM */
+
+/** \} */
+
+/* Public APIs */
+cy_p64_error_codes_t cy_p64_flash_write_row(uint32_t address, const uint32_t *data);
+cy_p64_error_codes_t cy_p64_flash_start_write(uint32_t address, const uint32_t *data);
+cy_p64_error_codes_t cy_p64_flash_start_program(uint32_t address, const uint32_t *data);
+cy_p64_error_codes_t cy_p64_flash_start_erase(uint32_t address, uint32_t size);
+bool cy_p64_flash_is_complete(cy_p64_error_codes_t *status);
+
+#endif /* CY_P64_FLASH_H */
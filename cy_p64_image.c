@@ -15,11 +15,45 @@
 *******************************************************************************/
 #include <string.h>
 #include "cy_p64_image.h"
-#include "cy_flash.h"
+#include "cy_p64_watchdog.h"
+#include "cy_p64_attest.h"
+#include "cy_p64_mcuboot.h"
+#include "cy_p64_jwt_policy.h"
+#include "cy_p64_keycache.h"
+#include "cy_p64_flash.h"
 
 #define CY_P64_USER_SWAP_IMAGE_OK_OFFS      (24u)
 #define CY_P64_USER_SWAP_IMAGE_OK           (1u)
 
+/* The largest block of the supported block ciphers */
+#define CY_P64_IMAGE_CIPHER_BLOCK_SIZE      (16u)
+
+/* The offset of the MCUboot image trailer magic from the end of the slot */
+#define CY_P64_USER_SWAP_MAGIC_OFFS         (16u)
+#define CY_P64_USER_SWAP_MAGIC_WORDS        (4u)
+
+/* The size of the raw ECDSA P-256 signature: r and s */
+#define CY_P64_IMAGE_ECDSA256_SIG_SIZE      (64u)
+#define CY_P64_IMAGE_ECDSA256_COORD_SIZE    (32u)
+
+/* ASN.1 DER tags of the ECDSA signature */
+#define CY_P64_IMAGE_DER_SEQUENCE           (0x30u)
+#define CY_P64_IMAGE_DER_INTEGER            (0x02u)
+
+/* The MCUboot image trailer magic, requests the swap of the upgrade image */
+static const uint32_t cy_p64_swap_magic[CY_P64_USER_SWAP_MAGIC_WORDS] =
+{
+    0xf395c277u, 0x7fefd260u, 0x0f505235u, 0x8079b62cu
+};
+
+/* The state of cy_p64_confirm_image_start(), the row buffer is used by
+ * the flash controller until the operation is complete */
+static cy_p64_flash_writer_t cy_p64_confirm_writer;
+static cy_p64_image_confirm_cb_t cy_p64_confirm_cb = NULL;
+static void *cy_p64_confirm_cb_arg = NULL;
+static uint32_t cy_p64_confirm_addr = 0u;
+static bool cy_p64_confirm_busy = false;
+
 /*******************************************************************************
 * Image Prototypes
 ****************************************************************************//**
@@ -31,41 +65,273 @@
 *
 * \{
 *   \defgroup image_api Functions
+*   \defgroup image_macros Macros
+*   \defgroup image_t Data Structures
 * \}
 *******************************************************************************/
 
 /*******************************************************************************
-* Function Name: cy_p64_flash_write_byte
+* Function Name: cy_p64_flash_wait
 ****************************************************************************//**
-* Writes 1 byte from "data" into flash memory at "address".
-* It does a sequence of RD/Modify/WR of data in a Flash Row.
+* Waits for the completion of the non-blocking flash operation and kicks
+* the WDT while waiting, at most \ref CY_P64_IMAGE_FLASH_TIMEOUT_MS measured
+* by cy_p64_wdg_timestamp(). The WDT counter stops when the WDT is disabled,
+* then there is no WDT to keep alive and the wait is not limited.
 *
-* \param[in] address        The address where to write.
-* \param[in] data           The data to write.
+* \return                   \ref CY_P64_SUCCESS for success,
+*                           \ref CY_P64_INVALID_TIMEOUT if the operation has
+*                           not completed in time or other error code.
+*******************************************************************************/
+static cy_p64_error_codes_t cy_p64_flash_wait(void)
+{
+    cy_p64_error_codes_t ret = CY_P64_INVALID_FLASH_OPERATION;
+    uint64_t start = cy_p64_wdg_timestamp();
+    bool complete;
+    bool expired = false;
+
+    do
+    {
+        complete = cy_p64_flash_is_complete(&ret);
+        if(!complete)
+        {
+            expired = ((cy_p64_wdg_timestamp() - start) >
+                       CY_P64_WDG_US_TO_TICKS((uint64_t)CY_P64_IMAGE_FLASH_TIMEOUT_MS * 1000u));
+            if(!expired)
+            {
+                cy_p64_wdg_heartbeat();
+            }
+        }
+    }
+    while((!complete) && (!expired));
+
+    if(expired)
+    {
+        ret = CY_P64_INVALID_TIMEOUT;
+    }
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_in_range
+****************************************************************************//**
+* Checks if the area lies in the main flash or in the work flash, the regions
+* programmed by Cy_Flash_WriteRow().
+*
+* \param address   The start address of the area.
+* \param size      The size of the area in bytes.
+* \return          true if the whole area is in one of the regions.
+*******************************************************************************/
+static bool cy_p64_flash_in_range(uint32_t address, uint32_t size)
+{
+    return (((address >= CY_FLASH_BASE) && ((address - CY_FLASH_BASE) <= CY_FLASH_SIZE) &&
+             (size <= (CY_FLASH_SIZE - (address - CY_FLASH_BASE)))) ||
+            ((address >= CY_EM_EEPROM_BASE) && ((address - CY_EM_EEPROM_BASE) <= CY_EM_EEPROM_SIZE) &&
+             (size <= (CY_EM_EEPROM_SIZE - (address - CY_EM_EEPROM_BASE)))));
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_image_upgrade_erase_next
+****************************************************************************//**
+* Erases the flash area at the end of the erased area of the upgrade slot:
+* the subsector if it is aligned and fits into the slot, otherwise the row.
+*
+* \param[in] ctx            The upgrade writer.
 * \return                   \ref CY_P64_SUCCESS for success or error code.
 *******************************************************************************/
-static cy_p64_error_codes_t cy_p64_flash_write_byte(uint32_t address, uint8_t data)
+static cy_p64_error_codes_t cy_p64_image_upgrade_erase_next(cy_p64_image_upgrade_t *ctx)
 {
-    cy_p64_error_codes_t ret = CY_P64_INVALID;
-    uint32_t row_addr = 0;
-    uint32_t row_buff[CY_FLASH_SIZEOF_ROW_LONG_UNITS];
-    uint8_t *row_buff_bytes = (uint8_t *)row_buff;
+    cy_p64_error_codes_t ret;
+    uint32_t addr = ctx->erased_end;
+    uint32_t slot_end = ctx->slot_addr + ctx->slot_size;
+    uint32_t size = CY_FLASH_SIZEOF_ROW;
 
-    /* Accepting an arbitrary address */
-    row_addr = (address / CY_FLASH_SIZEOF_ROW) * CY_FLASH_SIZEOF_ROW;
+    if(((addr % CY_P64_IMAGE_UPGRADE_ERASE_SIZE) == 0u) &&
+       ((slot_end - addr) >= CY_P64_IMAGE_UPGRADE_ERASE_SIZE))
+    {
+        size = CY_P64_IMAGE_UPGRADE_ERASE_SIZE;
+    }
+    ret = cy_p64_flash_start_erase(addr, size);
+    ctx->erased_end = addr + size;
+    cy_p64_attest_flash_written(addr, size);
 
-    /* Preserving Row */
-    (void)memcpy(row_buff, (uint32_t *)row_addr, sizeof(row_buff));
+    if(ret == CY_P64_SUCCESS)
+    {
+        ret = cy_p64_flash_wait();
+    }
 
-    /* Modifying the target byte */
-    row_buff_bytes[address % CY_FLASH_SIZEOF_ROW] = data;
+    return ret;
+}
 
-    /* Programming updated row back */
-    if(Cy_Flash_WriteRow(row_addr, row_buff) == CY_FLASH_DRV_SUCCESS)
+
+/*******************************************************************************
+* Function Name: cy_p64_image_upgrade_program_row
+****************************************************************************//**
+* Hashes the current row buffer and starts programming it at the write pointer,
+* erasing the next flash area first if the write pointer reached the end of
+* the erased area. The tail of the partial row is filled with the erased value.
+*
+* \param[in] ctx            The upgrade writer.
+* \return                   \ref CY_P64_SUCCESS for success or error code.
+*******************************************************************************/
+static cy_p64_error_codes_t cy_p64_image_upgrade_program_row(cy_p64_image_upgrade_t *ctx)
+{
+    cy_p64_error_codes_t ret = CY_P64_SUCCESS;
+    uint8_t *row = (uint8_t *)ctx->row[ctx->cur];
+
+    (void)memset(&row[ctx->fill], (int)CY_P64_MCUBOOT_ERASED_VAL, CY_FLASH_SIZEOF_ROW - ctx->fill);
+
+    if(ctx->busy)
     {
-        ret = CY_P64_SUCCESS;
+        ret = cy_p64_flash_wait();
+        ctx->busy = false;
+    }
+
+    if((ret == CY_P64_SUCCESS) && (ctx->write_addr >= ctx->erased_end))
+    {
+        ret = cy_p64_image_upgrade_erase_next(ctx);
+    }
+
+    if(ret == CY_P64_SUCCESS)
+    {
+        ret = cy_p64_flash_start_program(ctx->write_addr, ctx->row[ctx->cur]);
+        cy_p64_attest_flash_written(ctx->write_addr, CY_FLASH_SIZEOF_ROW);
+        if(ret == CY_P64_SUCCESS)
+        {
+            ctx->busy = true;
+        }
     }
 
+    if(ret == CY_P64_SUCCESS)
+    {
+        /* Hash the row while it is programmed */
+        ret = cy_p64_psa_hash_update(&ctx->hash, row, ctx->fill);
+        ctx->write_addr += CY_FLASH_SIZEOF_ROW;
+        ctx->fill = 0u;
+        ctx->cur ^= 1u;
+
+        cy_p64_wdg_heartbeat();
+    }
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_image_der_integer
+****************************************************************************//**
+* Reads one DER INTEGER of the ECDSA signature and stores it as a big-endian
+* number of CY_P64_IMAGE_ECDSA256_COORD_SIZE bytes.
+*
+* \param[in] der            The DER data.
+* \param[in,out] pos        The position of the INTEGER, set after it.
+* \param[in] end            The end of the DER data.
+* \param[out] out           The output number.
+* \return                   true if the INTEGER is valid.
+*******************************************************************************/
+static bool cy_p64_image_der_integer(const uint8_t *der, uint32_t *pos, uint32_t end, uint8_t *out)
+{
+    bool ret = false;
+    uint32_t p = *pos;
+    uint32_t len;
+
+    if(((end - p) >= 2u) && (der[p] == CY_P64_IMAGE_DER_INTEGER))
+    {
+        len = der[p + 1u];
+        p += 2u;
+        if((len > 0u) && (len <= (end - p)))
+        {
+            *pos = p + len;
+            /* Skip the sign padding */
+            while((len > CY_P64_IMAGE_ECDSA256_COORD_SIZE) && (der[p] == 0u))
+            {
+                p++;
+                len--;
+            }
+            if(len <= CY_P64_IMAGE_ECDSA256_COORD_SIZE)
+            {
+                (void)memset(out, 0, CY_P64_IMAGE_ECDSA256_COORD_SIZE - len);
+                (void)memcpy(&out[CY_P64_IMAGE_ECDSA256_COORD_SIZE - len], &der[p], len);
+                ret = true;
+            }
+        }
+    }
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_image_der_to_raw
+****************************************************************************//**
+* Converts the DER encoded ECDSA P-256 signature of the MCUboot image to
+* the raw r|s format of cy_p64_psa_verify_hash().
+*
+* \param[in] der            The DER signature.
+* \param[in] der_length     The length of the DER signature.
+* \param[out] raw           The raw signature, CY_P64_IMAGE_ECDSA256_SIG_SIZE bytes.
+* \return                   true if the signature is converted.
+*******************************************************************************/
+static bool cy_p64_image_der_to_raw(const uint8_t *der, uint32_t der_length, uint8_t *raw)
+{
+    bool ret = false;
+    uint32_t pos = 2u;
+    uint32_t end;
+
+    /* The P-256 signature is shorter than 128 bytes, the short length form is used */
+    if((der_length >= 2u) && (der[0] == CY_P64_IMAGE_DER_SEQUENCE) &&
+       (der[1] < 0x80u) && ((uint32_t)der[1] <= (der_length - 2u)))
+    {
+        end = 2u + der[1];
+        ret = cy_p64_image_der_integer(der, &pos, end, raw) &&
+              cy_p64_image_der_integer(der, &pos, end, &raw[CY_P64_IMAGE_ECDSA256_COORD_SIZE]) &&
+              (pos == end);
+    }
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_image_validate_progress
+****************************************************************************//**
+* The cy_p64_image_digest() progress callback of cy_p64_image_validate(),
+* sends the WDT heartbeat.
+*******************************************************************************/
+static void cy_p64_image_validate_progress(uint32_t processed, uint32_t total, void *arg)
+{
+    (void)processed;
+    (void)total;
+    (void)arg;
+
+    cy_p64_wdg_heartbeat();
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_image_same_sector
+****************************************************************************//**
+* Checks if the source area in flash shares a flash sector with the
+* destination area, so it cannot be read while the destination is programmed.
+*
+* \param src_address    The source address, RAM sources never conflict.
+* \param dst_address    The destination flash address.
+* \param size           The size of both areas in bytes.
+* \return     true if the areas have a common sector.
+*******************************************************************************/
+static bool cy_p64_image_same_sector(uint32_t src_address, uint32_t dst_address, uint32_t size)
+{
+    bool ret = false;
+
+    if((src_address >= CY_FLASH_BASE) && ((src_address - CY_FLASH_BASE) < CY_FLASH_SIZE))
+    {
+        ret = (((src_address - CY_FLASH_BASE) / CY_P64_FLASH_SECTOR_SIZE) <=
+               ((dst_address - CY_FLASH_BASE + size - 1u) / CY_P64_FLASH_SECTOR_SIZE)) &&
+              (((dst_address - CY_FLASH_BASE) / CY_P64_FLASH_SECTOR_SIZE) <=
+               ((src_address - CY_FLASH_BASE + size - 1u) / CY_P64_FLASH_SECTOR_SIZE));
+    }
     return ret;
 }
 
@@ -79,6 +345,144 @@ static cy_p64_error_codes_t cy_p64_flash_write_byte(uint32_t address, uint8_t da
 *  \{
 *******************************************************************************/
 
+/*******************************************************************************
+* Function Name: cy_p64_flash_writer_init
+****************************************************************************//**
+* Initializes the row-buffered flash writer. Nothing is buffered after
+* the initialization.
+*
+* \param[out] writer        The flash writer.
+*******************************************************************************/
+void cy_p64_flash_writer_init(cy_p64_flash_writer_t *writer)
+{
+    if(writer != NULL)
+    {
+        writer->row_addr = 0u;
+        writer->loaded = false;
+        writer->dirty = false;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_writer_write
+****************************************************************************//**
+* Writes the data to flash through the row buffer. The bytes falling into the
+* buffered row are only changed in RAM. When the data reaches another row,
+* the buffered row is programmed and the new row is read into the buffer,
+* so each row is programmed once for a sequence of the neighbouring writes.
+* Call cy_p64_flash_writer_flush() to program the last row.
+*
+* \param[in] writer         The flash writer.
+* \param[in] address        The flash address where to write, any alignment,
+*                           in the main flash or in the work flash.
+* \param[in] data           The data to write.
+* \param[in] size           The size of the data in bytes.
+* \return     \ref CY_P64_SUCCESS for success,
+*             \ref CY_P64_INVALID_ADDR_OUT_OF_RANGE if the area is outside
+*             the main and the work flash, or other error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_flash_writer_write(cy_p64_flash_writer_t *writer,
+                                               uint32_t address,
+                                               const uint8_t *data,
+                                               uint32_t size)
+{
+    cy_p64_error_codes_t ret = CY_P64_SUCCESS;
+    uint8_t *row_bytes;
+    uint32_t row_addr;
+    uint32_t offset;
+    uint32_t chunk;
+    uint32_t done = 0u;
+
+    if((writer == NULL) || ((data == NULL) && (size != 0u)))
+    {
+        ret = CY_P64_INVALID_ARGUMENT;
+    }
+    else if(!cy_p64_flash_in_range(address, size))
+    {
+        ret = CY_P64_INVALID_ADDR_OUT_OF_RANGE;
+    }
+    else
+    {
+        row_bytes = (uint8_t *)writer->row;
+
+        while((ret == CY_P64_SUCCESS) && (done < size))
+        {
+            row_addr = ((address + done) / CY_FLASH_SIZEOF_ROW) * CY_FLASH_SIZEOF_ROW;
+            offset = (address + done) - row_addr;
+            chunk = CY_FLASH_SIZEOF_ROW - offset;
+            if(chunk > (size - done))
+            {
+                chunk = size - done;
+            }
+
+            if((!writer->loaded) || (writer->row_addr != row_addr))
+            {
+                ret = cy_p64_flash_writer_flush(writer);
+                if(ret == CY_P64_SUCCESS)
+                {
+                    /* Preserving Row */
+                    (void)memcpy(writer->row, cy_p64_flash_ptr(row_addr), sizeof(writer->row));
+                    writer->row_addr = row_addr;
+                    writer->loaded = true;
+                }
+            }
+
+            if(ret == CY_P64_SUCCESS)
+            {
+                if(memcmp(&row_bytes[offset], &data[done], chunk) != 0)
+                {
+                    (void)memcpy(&row_bytes[offset], &data[done], chunk);
+                    writer->dirty = true;
+                }
+                done += chunk;
+            }
+        }
+    }
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_writer_flush
+****************************************************************************//**
+* Programs the buffered row if it was changed. The row is not programmed when
+* its content is the same as in flash.
+*
+* \param[in] writer         The flash writer.
+* \return     \ref CY_P64_SUCCESS for success or error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_flash_writer_flush(cy_p64_flash_writer_t *writer)
+{
+    cy_p64_error_codes_t ret = CY_P64_SUCCESS;
+
+    if(writer == NULL)
+    {
+        ret = CY_P64_INVALID_ARGUMENT;
+    }
+    else if(writer->loaded && writer->dirty)
+    {
+        if(memcmp(writer->row, cy_p64_flash_ptr(writer->row_addr), sizeof(writer->row)) != 0)
+        {
+            /* Programming updated row back */
+            ret = cy_p64_flash_write_row(writer->row_addr, writer->row);
+            cy_p64_attest_flash_written(writer->row_addr, CY_FLASH_SIZEOF_ROW);
+        }
+        if(ret == CY_P64_SUCCESS)
+        {
+            writer->dirty = false;
+        }
+    }
+    else
+    {
+        /* Nothing to program */
+    }
+
+    return ret;
+}
+
+
 /*******************************************************************************
 * Function Name: cy_p64_is_image_confirmed
 ****************************************************************************//**
@@ -94,7 +498,7 @@ bool cy_p64_is_image_confirmed(uint32_t image_start, uint32_t image_size)
     uint32_t img_ok_addr;
 
     img_ok_addr = image_start + image_size - CY_P64_USER_SWAP_IMAGE_OK_OFFS;
-    ret = (*((uint8_t *)img_ok_addr) == CY_P64_USER_SWAP_IMAGE_OK);
+    ret = (*cy_p64_flash_ptr(img_ok_addr) == CY_P64_USER_SWAP_IMAGE_OK);
 
     return ret;
 }
@@ -115,19 +519,725 @@ cy_p64_error_codes_t cy_p64_confirm_image(uint32_t image_start, uint32_t image_s
 {
     cy_p64_error_codes_t ret = CY_P64_INVALID;
     uint32_t img_ok_addr;
+    cy_p64_flash_writer_t writer;
+    const uint8_t image_ok = CY_P64_USER_SWAP_IMAGE_OK;
 
     img_ok_addr = image_start + image_size - CY_P64_USER_SWAP_IMAGE_OK_OFFS;
 
     /* Write the Image OK flag to the slot trailer, so CypressBootloader
      * will not revert the new image */
-    if (*((uint8_t *)img_ok_addr) == CY_P64_USER_SWAP_IMAGE_OK)
+    if (*cy_p64_flash_ptr(img_ok_addr) == CY_P64_USER_SWAP_IMAGE_OK)
     {
         /* Image OK is already set in the trailer */
         ret = CY_P64_SUCCESS;
     }
     else
     {
-        ret = cy_p64_flash_write_byte(img_ok_addr, CY_P64_USER_SWAP_IMAGE_OK);
+        cy_p64_flash_writer_init(&writer);
+        ret = cy_p64_flash_writer_write(&writer, img_ok_addr, &image_ok, 1u);
+        if(ret == CY_P64_SUCCESS)
+        {
+            ret = cy_p64_flash_writer_flush(&writer);
+        }
+    }
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_confirm_image_start
+****************************************************************************//**
+* Starts writing the Image OK flag to the slot trailer with the non-blocking
+* flash operation and returns without waiting for the erase and program cycle.
+* Call cy_p64_confirm_image_poll() periodically, e.g. from the main loop or
+* the idle task, until it returns "true". The callback is called when the
+* operation is complete. If the Image OK flag is already set, the callback is
+* called before this function returns.
+*
+* Do not read the flash sector of the trailer until the operation is complete.
+*
+* \param[in] image_start    The start address of the image.
+* \param[in] image_size     The size of the image.
+* \param[in] callback       The completion callback, can be NULL.
+* \param[in] cb_arg         The user argument passed to \p callback.
+* \return     \ref CY_P64_SUCCESS if the operation is started or complete,
+*             \ref CY_P64_INVALID if another confirmation is in progress or
+*             other error code. The callback is not called on error.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_confirm_image_start(uint32_t image_start,
+                                                uint32_t image_size,
+                                                cy_p64_image_confirm_cb_t callback,
+                                                void *cb_arg)
+{
+    cy_p64_error_codes_t ret = CY_P64_INVALID;
+    const uint8_t image_ok = CY_P64_USER_SWAP_IMAGE_OK;
+
+    if(!cy_p64_confirm_busy)
+    {
+        cy_p64_confirm_addr = image_start + image_size - CY_P64_USER_SWAP_IMAGE_OK_OFFS;
+        cy_p64_confirm_cb = callback;
+        cy_p64_confirm_cb_arg = cb_arg;
+
+        cy_p64_flash_writer_init(&cy_p64_confirm_writer);
+        ret = cy_p64_flash_writer_write(&cy_p64_confirm_writer, cy_p64_confirm_addr, &image_ok, 1u);
+        if((ret == CY_P64_SUCCESS) && cy_p64_confirm_writer.dirty)
+        {
+            ret = cy_p64_flash_start_write(cy_p64_confirm_writer.row_addr, cy_p64_confirm_writer.row);
+            if(ret == CY_P64_SUCCESS)
+            {
+                /* The blocking driver completes the operation before it returns,
+                 * the poll reports the completion in both cases */
+                cy_p64_confirm_busy = true;
+            }
+        }
+        else if(ret == CY_P64_SUCCESS)
+        {
+            /* Image OK is already set in the trailer */
+            if(cy_p64_confirm_cb != NULL)
+            {
+                cy_p64_confirm_cb(CY_P64_SUCCESS, cy_p64_confirm_cb_arg);
+            }
+        }
+        else
+        {
+            /* Error is returned to the caller */
+        }
+    }
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_confirm_image_poll
+****************************************************************************//**
+* Checks the operation started by cy_p64_confirm_image_start() and calls
+* the completion callback when it is complete.
+*
+* \return     "true" if no confirmation is in progress, "false" if the flash
+*             operation is not complete yet.
+*******************************************************************************/
+bool cy_p64_confirm_image_poll(void)
+{
+    cy_p64_error_codes_t status = CY_P64_INVALID_FLASH_OPERATION;
+    bool ret = true;
+
+    if(cy_p64_confirm_busy)
+    {
+        ret = cy_p64_flash_is_complete(&status);
+        if(ret)
+        {
+            cy_p64_confirm_busy = false;
+            cy_p64_attest_flash_written(cy_p64_confirm_writer.row_addr, CY_FLASH_SIZEOF_ROW);
+
+            if((status == CY_P64_SUCCESS) &&
+               (*cy_p64_flash_ptr(cy_p64_confirm_addr) != CY_P64_USER_SWAP_IMAGE_OK))
+            {
+                status = CY_P64_INVALID_FLASH_OPERATION;
+            }
+            if(cy_p64_confirm_cb != NULL)
+            {
+                cy_p64_confirm_cb(status, cy_p64_confirm_cb_arg);
+            }
+        }
+    }
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_image_digest
+****************************************************************************//**
+* Calculates the hash of a memory region, for example a boot or upgrade slot.
+* The region is passed to cy_p64_psa_hash_update() directly from flash, without
+* copying to RAM, in chunks of \ref CY_P64_IMAGE_DIGEST_CHUNK_SIZE bytes.
+* The optional callback is called after each chunk, so the caller can report
+* the progress or kick the WDT.
+*
+* \param[in] address        The start address of the region.
+* \param[in] size           The size of the region in bytes.
+* \param[in] alg            The hash algorithm, e.g. CY_P64_PSA_ALG_SHA_256.
+* \param[out] hash          The buffer for the calculated hash.
+* \param[in] hash_size      The size of the \p hash buffer in bytes.
+* \param[out] hash_length   The number of bytes written to \p hash.
+* \param[in] callback       The progress callback, can be NULL.
+* \param[in] cb_arg         The user argument passed to \p callback.
+* \return     \ref CY_P64_SUCCESS for success or error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_image_digest(uint32_t address,
+                                         uint32_t size,
+                                         cy_p64_psa_algorithm_t alg,
+                                         uint8_t *hash,
+                                         size_t hash_size,
+                                         size_t *hash_length,
+                                         cy_p64_image_digest_cb_t callback,
+                                         void *cb_arg)
+{
+    cy_p64_error_codes_t ret = CY_P64_INVALID;
+    cy_p64_psa_hash_operation_t operation = CY_P64_PSA_HASH_OPERATION_INIT;
+    uint32_t offset = 0u;
+    uint32_t chunk;
+
+    if((hash == NULL) || (hash_length == NULL))
+    {
+        ret = CY_P64_INVALID_OUT_PAR;
+    }
+    else
+    {
+        ret = cy_p64_psa_hash_setup(&operation, alg);
+
+        while((ret == CY_P64_SUCCESS) && (offset < size))
+        {
+            chunk = size - offset;
+            if(chunk > CY_P64_IMAGE_DIGEST_CHUNK_SIZE)
+            {
+                chunk = CY_P64_IMAGE_DIGEST_CHUNK_SIZE;
+            }
+
+            ret = cy_p64_psa_hash_update(&operation, cy_p64_flash_ptr(address + offset), chunk);
+            offset += chunk;
+
+            if((ret == CY_P64_SUCCESS) && (callback != NULL))
+            {
+                callback(offset, size, cb_arg);
+            }
+        }
+
+        if(ret == CY_P64_SUCCESS)
+        {
+            ret = cy_p64_psa_hash_finish(&operation, hash, hash_size, hash_length);
+        }
+    }
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_image_upgrade_begin
+****************************************************************************//**
+* Starts writing a new image to the upgrade slot, e.g. the slot returned by
+* cy_p64_policy_get_image_address_and_size() for the "UPGRADE" image type.
+* Pass the received image to cy_p64_image_upgrade_write() in chunks of any
+* size, then call cy_p64_image_upgrade_finish() to verify the digest and to
+* request the upgrade. The writer erases the slot ahead of the write pointer
+* by \ref CY_P64_IMAGE_UPGRADE_ERASE_SIZE, programs the full rows with the
+* non-blocking flash operation and hashes the data while the row is
+* programmed, so the RAM usage does not depend on the image size.
+*
+* The last row of the slot is reserved for the trailer. Call
+* cy_p64_image_upgrade_abort() to cancel the upgrade after the successful
+* start.
+*
+* \param[out] ctx           The upgrade writer.
+* \param[in] slot_addr      The row aligned start address of the upgrade slot.
+* \param[in] slot_size      The row aligned size of the upgrade slot.
+* \param[in] alg            The hash algorithm, e.g. CY_P64_PSA_ALG_SHA_256.
+* \return     \ref CY_P64_SUCCESS for success or error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_image_upgrade_begin(cy_p64_image_upgrade_t *ctx,
+                                                uint32_t slot_addr,
+                                                uint32_t slot_size,
+                                                cy_p64_psa_algorithm_t alg)
+{
+    cy_p64_error_codes_t ret;
+
+    if((ctx == NULL) || ((slot_addr % CY_FLASH_SIZEOF_ROW) != 0u) ||
+       ((slot_size % CY_FLASH_SIZEOF_ROW) != 0u) || (slot_size < (2u * CY_FLASH_SIZEOF_ROW)))
+    {
+        ret = CY_P64_INVALID_ARGUMENT;
+    }
+    else if((slot_addr < CY_FLASH_BASE) || ((slot_addr - CY_FLASH_BASE) > CY_FLASH_SIZE) ||
+            (slot_size > (CY_FLASH_SIZE - (slot_addr - CY_FLASH_BASE))))
+    {
+        ret = CY_P64_INVALID_ADDR_OUT_OF_RANGE;
+    }
+    else
+    {
+        ctx->slot_addr = slot_addr;
+        ctx->slot_size = slot_size;
+        ctx->write_addr = slot_addr;
+        ctx->erased_end = slot_addr;
+        ctx->fill = 0u;
+        ctx->cur = 0u;
+        ctx->busy = false;
+        ctx->hash = cy_p64_psa_hash_operation_init();
+
+        ret = cy_p64_psa_hash_setup(&ctx->hash, alg);
+    }
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_image_upgrade_write
+****************************************************************************//**
+* Appends the chunk of the image. The data is copied to the row buffer and
+* each full row is programmed.
+*
+* \param[in] ctx            The upgrade writer.
+* \param[in] data           The chunk of the image.
+* \param[in] length         The length of the chunk, any value.
+* \return     \ref CY_P64_SUCCESS for success,
+*             \ref CY_P64_INVALID_ADDR_OUT_OF_RANGE if the image overlaps
+*             the trailer row or other error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_image_upgrade_write(cy_p64_image_upgrade_t *ctx,
+                                                const uint8_t *data,
+                                                uint32_t length)
+{
+    cy_p64_error_codes_t ret = CY_P64_SUCCESS;
+    uint32_t chunk;
+    uint32_t done = 0u;
+    uint32_t image_limit;
+
+    if((ctx == NULL) || ((data == NULL) && (length != 0u)))
+    {
+        ret = CY_P64_INVALID_ARGUMENT;
+    }
+    else
+    {
+        image_limit = ctx->slot_addr + ctx->slot_size - CY_FLASH_SIZEOF_ROW;
+        if(length > (image_limit - ctx->write_addr - ctx->fill))
+        {
+            ret = CY_P64_INVALID_ADDR_OUT_OF_RANGE;
+        }
+
+        while((ret == CY_P64_SUCCESS) && (done < length))
+        {
+            chunk = CY_FLASH_SIZEOF_ROW - ctx->fill;
+            if(chunk > (length - done))
+            {
+                chunk = length - done;
+            }
+            (void)memcpy(&((uint8_t *)ctx->row[ctx->cur])[ctx->fill], &data[done], chunk);
+            ctx->fill += chunk;
+            done += chunk;
+
+            if(ctx->fill == CY_FLASH_SIZEOF_ROW)
+            {
+                ret = cy_p64_image_upgrade_program_row(ctx);
+            }
+        }
+    }
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_image_upgrade_finish
+****************************************************************************//**
+* Programs the last partial row, compares the hash of the received image with
+* the expected one, erases the rest of the slot and writes the MCUboot trailer
+* of the upgrade slot: the magic, which requests the swap on the next boot,
+* and optionally the Image OK flag. The trailer is not written if the hash
+* does not match. The writer is released in any case.
+*
+* \param[in] ctx            The upgrade writer.
+* \param[in] hash           The expected hash of the image.
+* \param[in] hash_length    The length of the expected hash.
+* \param[in] permanent      "true" to set the Image OK flag, so the upgrade
+*                           is not reverted.
+* \return     \ref CY_P64_SUCCESS for success,
+*             \ref CY_P64_INVALID_CRYPTO_OPER if the hash does not match or
+*             other error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_image_upgrade_finish(cy_p64_image_upgrade_t *ctx,
+                                                 const uint8_t *hash,
+                                                 size_t hash_length,
+                                                 bool permanent)
+{
+    cy_p64_error_codes_t ret = CY_P64_SUCCESS;
+    cy_p64_error_codes_t status;
+    uint8_t actual[CY_P64_PSA_HASH_MAX_SIZE];
+    size_t actual_length = 0u;
+    uint8_t diff = 0u;
+    uint32_t trailer_addr;
+    uint32_t *row;
+    size_t i;
+
+    if(ctx == NULL)
+    {
+        ret = CY_P64_INVALID_ARGUMENT;
+    }
+    else if(hash == NULL)
+    {
+        /* Release the writer and its hash operation */
+        cy_p64_image_upgrade_abort(ctx);
+        ret = CY_P64_INVALID_ARGUMENT;
+    }
+    else
+    {
+        if(ctx->fill != 0u)
+        {
+            ret = cy_p64_image_upgrade_program_row(ctx);
+        }
+
+        if(ctx->busy)
+        {
+            status = cy_p64_flash_wait();
+            ctx->busy = false;
+            if(ret == CY_P64_SUCCESS)
+            {
+                ret = status;
+            }
+        }
+
+        /* Finish the hash in any case to free the operation */
+        status = cy_p64_psa_hash_finish(&ctx->hash, actual, sizeof(actual), &actual_length);
+        if(ret == CY_P64_SUCCESS)
+        {
+            ret = status;
+        }
+
+        if(ret == CY_P64_SUCCESS)
+        {
+            if(actual_length != hash_length)
+            {
+                ret = CY_P64_INVALID_CRYPTO_OPER;
+            }
+            else
+            {
+                for(i = 0u; i < hash_length; i++)
+                {
+                    diff |= (uint8_t)(actual[i] ^ hash[i]);
+                }
+                if(diff != 0u)
+                {
+                    ret = CY_P64_INVALID_CRYPTO_OPER;
+                }
+            }
+        }
+
+        /* Erase the rest of the slot, so the old image and the stale swap
+         * status of the previous upgrade are not left before the trailer */
+        trailer_addr = ctx->slot_addr + ctx->slot_size - CY_FLASH_SIZEOF_ROW;
+        while((ret == CY_P64_SUCCESS) && (ctx->erased_end < trailer_addr))
+        {
+            ret = cy_p64_image_upgrade_erase_next(ctx);
+        }
+
+        if(ret == CY_P64_SUCCESS)
+        {
+            row = ctx->row[ctx->cur];
+            (void)memset(row, (int)CY_P64_MCUBOOT_ERASED_VAL, CY_FLASH_SIZEOF_ROW);
+            (void)memcpy(&((uint8_t *)row)[CY_FLASH_SIZEOF_ROW - CY_P64_USER_SWAP_MAGIC_OFFS],
+                         cy_p64_swap_magic, sizeof(cy_p64_swap_magic));
+            if(permanent)
+            {
+                ((uint8_t *)row)[CY_FLASH_SIZEOF_ROW - CY_P64_USER_SWAP_IMAGE_OK_OFFS] = CY_P64_USER_SWAP_IMAGE_OK;
+            }
+
+            ret = cy_p64_flash_write_row(trailer_addr, row);
+            cy_p64_attest_flash_written(trailer_addr, CY_FLASH_SIZEOF_ROW);
+        }
+
+        (void)memset(ctx->row, 0, sizeof(ctx->row));
+    }
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_image_upgrade_abort
+****************************************************************************//**
+* Cancels the upgrade started by cy_p64_image_upgrade_begin(). It waits for
+* the pending flash operation and releases the hash operation. The trailer
+* is not written, so the partially written image is not booted.
+*
+* \param[in] ctx            The upgrade writer.
+*******************************************************************************/
+void cy_p64_image_upgrade_abort(cy_p64_image_upgrade_t *ctx)
+{
+    uint8_t actual[CY_P64_PSA_HASH_MAX_SIZE];
+    size_t actual_length = 0u;
+
+    if(ctx != NULL)
+    {
+        if(ctx->busy)
+        {
+            (void)cy_p64_flash_wait();
+            ctx->busy = false;
+        }
+        /* Secure FlashBoot has no hash abort, the operation is released by finish */
+        (void)cy_p64_psa_hash_finish(&ctx->hash, actual, sizeof(actual), &actual_length);
+        (void)memset(ctx->row, 0, sizeof(ctx->row));
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_image_validate
+****************************************************************************//**
+* Validates the image in the upgrade slot the same way as the bootloader does
+* it on the next reboot, so a bad upgrade image is rejected before the reboot.
+* The function parses the MCUboot header and TLVs, hashes the header, the
+* payload and the protected TLVs directly from flash with PSA, compares the
+* hash with the SHA-256 TLV and verifies the ECDSA P-256 signature TLV with
+* the keys listed in the "upgrade_auth" array of the image policy. The image
+* is not copied to RAM. The WDT is kicked while hashing, if it is enabled.
+*
+* \param[in] json           The JSON object with the provisioning policy.
+* \param[in] image_id       The image ID.
+* \return     \ref CY_P64_SUCCESS if the image is valid,
+*             \ref CY_P64_INVALID_ARGUMENT if the slot has no valid image header
+*             or TLVs, \ref CY_P64_INVALID_CRYPTO_OPER if the hash or the
+*             signature does not match or other error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_image_validate(const cy_p64_cJSON *json, uint32_t image_id)
+{
+    cy_p64_error_codes_t ret;
+    cy_p64_mcuboot_slot_t slot;
+    const cy_p64_cJSON *json_image = NULL;
+    const cy_p64_cJSON *auth = NULL;
+    uint8_t hash[CY_P64_PSA_HASH_SIZE(CY_P64_PSA_ALG_SHA_256)];
+    uint8_t signature[CY_P64_IMAGE_ECDSA256_SIG_SIZE];
+    size_t hash_length = 0u;
+    uint32_t slot_addr = 0u;
+    uint32_t slot_size = 0u;
+    uint32_t tlv_addr = 0u;
+    uint32_t tlv_length = 0u;
+    uint32_t key_id;
+    uint32_t keys = 0u;
+    uint32_t i;
+    uint8_t diff = 0u;
+    bool verified = false;
+
+    ret = cy_p64_policy_get_image_address_and_size(json, image_id, "UPGRADE", &slot_addr, &slot_size);
+    if(ret == CY_P64_SUCCESS)
+    {
+        ret = cy_p64_policy_get_image_record(json, image_id, &json_image);
+    }
+    if(ret == CY_P64_SUCCESS)
+    {
+        auth = cy_p64_cJSON_GetObjectItem(json_image, "upgrade_auth");
+        if((auth == NULL) || (auth->type != CY_P64_cJSON_Array))
+        {
+            ret = CY_P64_JWT_ERR_JSN_NONOBJ;
+        }
+        else
+        {
+            keys = (uint32_t)cy_p64_cJSON_GetArraySize(auth);
+            if(keys > CY_P64_IMAGE_MAX_AUTH_KEYS)
+            {
+                keys = CY_P64_IMAGE_MAX_AUTH_KEYS;
+            }
+        }
+    }
+
+    if(ret == CY_P64_SUCCESS)
+    {
+        ret = cy_p64_mcuboot_slot_info(slot_addr, slot_size, &slot);
+    }
+    if((ret == CY_P64_SUCCESS) && (!slot.header_valid))
+    {
+        ret = CY_P64_INVALID_ARGUMENT;
+    }
+
+    /* The hash covers the header, the payload and the protected TLVs */
+    if(ret == CY_P64_SUCCESS)
+    {
+        ret = cy_p64_image_digest(slot_addr, slot.hdr_size + slot.img_size + slot.prot_tlv_size,
+                                  CY_P64_PSA_ALG_SHA_256, hash, sizeof(hash), &hash_length,
+                                  &cy_p64_image_validate_progress, NULL);
+    }
+    if(ret == CY_P64_SUCCESS)
+    {
+        ret = cy_p64_mcuboot_tlv_find(&slot, CY_P64_MCUBOOT_TLV_SHA256, &tlv_addr, &tlv_length);
+        if(ret == CY_P64_INVALID)
+        {
+            ret = CY_P64_INVALID_ARGUMENT;
+        }
+    }
+    if(ret == CY_P64_SUCCESS)
+    {
+        if(tlv_length != hash_length)
+        {
+            ret = CY_P64_INVALID_CRYPTO_OPER;
+        }
+        else
+        {
+            for(i = 0u; i < hash_length; i++)
+            {
+                diff |= (uint8_t)(hash[i] ^ cy_p64_flash_ptr(tlv_addr)[i]);
+            }
+            if(diff != 0u)
+            {
+                ret = CY_P64_INVALID_CRYPTO_OPER;
+            }
+        }
+    }
+
+    if(ret == CY_P64_SUCCESS)
+    {
+        ret = cy_p64_mcuboot_tlv_find(&slot, CY_P64_MCUBOOT_TLV_ECDSA256, &tlv_addr, &tlv_length);
+        if(ret == CY_P64_INVALID)
+        {
+            ret = CY_P64_INVALID_ARGUMENT;
+        }
+        else if((ret == CY_P64_SUCCESS) &&
+                (!cy_p64_image_der_to_raw(cy_p64_flash_ptr(tlv_addr), tlv_length, signature)))
+        {
+            ret = CY_P64_INVALID_ARGUMENT;
+        }
+        else
+        {
+            /* The error is returned */
+        }
+    }
+
+    /* Any key of the upgrade_auth array can sign the image */
+    for(i = 0u; (i < keys) && (ret == CY_P64_SUCCESS) && (!verified); i++)
+    {
+        if(cy_p64_json_get_uint32(cy_p64_cJSON_GetArrayItem(auth, (int)i), &key_id) == CY_P64_SUCCESS)
+        {
+            verified = (cy_p64_pubkey_cache_verify_hash(key_id,
+                                                        CY_P64_PSA_ALG_ECDSA(CY_P64_PSA_ALG_SHA_256),
+                                                        hash, hash_length,
+                                                        signature, sizeof(signature)) == CY_P64_PSA_SUCCESS);
+        }
+    }
+    if((ret == CY_P64_SUCCESS) && (!verified))
+    {
+        ret = CY_P64_INVALID_CRYPTO_OPER;
+    }
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_image_install_encrypted
+****************************************************************************//**
+* Decrypts the image and programs it to flash row by row. Two row buffers are
+* used: while one row is programmed by the non-blocking flash operation, the
+* next row is decrypted into the other buffer, so the install time is close
+* to the longer of the decryption and programming times. The WDT is kicked
+* after each row and while waiting for flash, if it is enabled.
+*
+* The cipher must produce the output of the same size as the input for each
+* row, e.g. CY_P64_PSA_ALG_CTR, or CY_P64_PSA_ALG_CBC_NO_PADDING with the size
+* aligned to the cipher block. The tail of the last row is filled with
+* \ref CY_P64_MCUBOOT_ERASED_VAL. On error the destination contains a
+* partially programmed image.
+*
+* The source is read while the previous row is programmed, so the source in
+* flash must lie in other flash sectors (\ref CY_P64_FLASH_SECTOR_SIZE) than
+* the destination (read-while-write), otherwise the function fails with
+* \ref CY_P64_INVALID_ARGUMENT.
+*
+* \param[in] dst_address    The row aligned flash address to program.
+* \param[in] src            The encrypted image, can be in flash.
+* \param[in] size           The size of the image in bytes.
+* \param[in] key            The cipher key handle.
+* \param[in] alg            The cipher algorithm.
+* \param[in] iv             The IV.
+* \param[in] iv_length      The IV length.
+* \return     \ref CY_P64_SUCCESS for success or error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_image_install_encrypted(uint32_t dst_address,
+                                                    const uint8_t *src,
+                                                    uint32_t size,
+                                                    cy_p64_psa_key_handle_t key,
+                                                    cy_p64_psa_algorithm_t alg,
+                                                    const uint8_t *iv,
+                                                    size_t iv_length)
+{
+    cy_p64_error_codes_t ret;
+    cy_p64_error_codes_t status;
+    cy_p64_psa_cipher_operation_t operation = CY_P64_PSA_CIPHER_OPERATION_INIT;
+    uint32_t row_buff[2u][CY_FLASH_SIZEOF_ROW_LONG_UNITS];
+    uint8_t tail[CY_P64_IMAGE_CIPHER_BLOCK_SIZE];
+    uint8_t *row;
+    uint32_t offset = 0u;
+    uint32_t chunk;
+    size_t length = 0u;
+    bool busy = false;
+
+    if((src == NULL) || (size == 0u) || ((dst_address % CY_FLASH_SIZEOF_ROW) != 0u))
+    {
+        ret = CY_P64_INVALID_ARGUMENT;
+    }
+    else if((dst_address < CY_FLASH_BASE) || ((dst_address - CY_FLASH_BASE) > CY_FLASH_SIZE) ||
+            (size > (CY_FLASH_SIZE - (dst_address - CY_FLASH_BASE))))
+    {
+        ret = CY_P64_INVALID_ADDR_OUT_OF_RANGE;
+    }
+    else if(cy_p64_image_same_sector((uint32_t)src, dst_address, size))
+    {
+        ret = CY_P64_INVALID_ARGUMENT;
+    }
+    else
+    {
+        ret = cy_p64_psa_cipher_decrypt_setup(&operation, key, alg);
+        if(ret == CY_P64_SUCCESS)
+        {
+            ret = cy_p64_psa_cipher_set_iv(&operation, iv, iv_length);
+
+            while((ret == CY_P64_SUCCESS) && (offset < size))
+            {
+                /* The other buffer may still be programmed */
+                row = (uint8_t *)row_buff[(offset / CY_FLASH_SIZEOF_ROW) & 1u];
+                chunk = size - offset;
+                if(chunk > CY_FLASH_SIZEOF_ROW)
+                {
+                    chunk = CY_FLASH_SIZEOF_ROW;
+                }
+
+                ret = cy_p64_psa_cipher_update(&operation, &src[offset], chunk,
+                                               row, CY_FLASH_SIZEOF_ROW, &length);
+                if((ret == CY_P64_SUCCESS) && (length != chunk))
+                {
+                    ret = CY_P64_INVALID_CRYPTO_OPER;
+                }
+                if(ret == CY_P64_SUCCESS)
+                {
+                    (void)memset(&row[chunk], (int)CY_P64_MCUBOOT_ERASED_VAL, CY_FLASH_SIZEOF_ROW - chunk);
+                    if(busy)
+                    {
+                        ret = cy_p64_flash_wait();
+                        busy = false;
+                    }
+                }
+                if(ret == CY_P64_SUCCESS)
+                {
+                    ret = cy_p64_flash_start_write(dst_address + offset, (const uint32_t *)row);
+                    cy_p64_attest_flash_written(dst_address + offset, CY_FLASH_SIZEOF_ROW);
+                    if(ret == CY_P64_SUCCESS)
+                    {
+                        busy = true;
+                    }
+                }
+                offset += chunk;
+            }
+
+            /* Finish the cipher in any case to free the operation,
+             * nothing is expected in the output */
+            length = 0u;
+            status = cy_p64_psa_cipher_finish(&operation, tail, sizeof(tail), &length);
+            if((ret == CY_P64_SUCCESS) && ((status != CY_P64_SUCCESS) || (length != 0u)))
+            {
+                ret = CY_P64_INVALID_CRYPTO_OPER;
+            }
+        }
+
+        if(busy)
+        {
+            status = cy_p64_flash_wait();
+            if(ret == CY_P64_SUCCESS)
+            {
+                ret = status;
+            }
+        }
+
+        /* Clear the plaintext */
+        (void)memset(row_buff, 0, sizeof(row_buff));
+        (void)memset(tail, 0, sizeof(tail));
     }
 
     return ret;
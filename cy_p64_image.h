@@ -20,8 +20,148 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "cy_p64_syscall.h"
+#include "cy_p64_psacrypto.h"
+#include "cy_p64_cJSON.h"
+#include "cy_p64_flash.h"
 
+/** \addtogroup image_macros
+ * \{
+ */
+
+/** The number of flash bytes passed to one cy_p64_psa_hash_update() call by
+ * cy_p64_image_digest(). Each call is a separate Secure FlashBoot syscall, so
+ * a larger value gives higher throughput and a smaller value gives shorter
+ * intervals between the progress callback invocations. */
+#ifndef CY_P64_IMAGE_DIGEST_CHUNK_SIZE
+#define CY_P64_IMAGE_DIGEST_CHUNK_SIZE      (0x20000u)
+#endif /* CY_P64_IMAGE_DIGEST_CHUNK_SIZE */
+
+/** The flash area erased at once by the upgrade writer ahead of the write
+ * pointer: the flash subsector (8 rows). One subsector erase takes about
+ * the same time as one row erase. Set to CY_P64_FLASH_ROW_SIZE to erase
+ * row by row. */
+#ifndef CY_P64_IMAGE_UPGRADE_ERASE_SIZE
+#define CY_P64_IMAGE_UPGRADE_ERASE_SIZE     CY_P64_FLASH_SUBSECTOR_SIZE
+#endif /* CY_P64_IMAGE_UPGRADE_ERASE_SIZE */
+
+/** The maximum time in milliseconds to wait for one non-blocking flash
+ * operation (row program or subsector erase). The WDT is kicked only within
+ * this time, after it the operation fails with \ref CY_P64_INVALID_TIMEOUT. */
+#ifndef CY_P64_IMAGE_FLASH_TIMEOUT_MS
+#define CY_P64_IMAGE_FLASH_TIMEOUT_MS       (100u)
+#endif /* CY_P64_IMAGE_FLASH_TIMEOUT_MS */
+
+/** The maximum number of keys in the "upgrade_auth" policy array tried by
+ * cy_p64_image_validate() */
+#ifndef CY_P64_IMAGE_MAX_AUTH_KEYS
+#define CY_P64_IMAGE_MAX_AUTH_KEYS          (4u)
+#endif /* CY_P64_IMAGE_MAX_AUTH_KEYS */
+
+/** \} */
+
+/** \addtogroup image_t
+ * \{
+ */
+
+/** The progress callback of cy_p64_image_digest(). It is called after each
+ * hashed chunk, so it can be used to kick the WDT.
+ *
+ * \param processed   The number of bytes hashed so far.
+ * \param total       The total number of bytes to hash.
+ * \param arg         The user argument passed to cy_p64_image_digest().
+ */
+typedef void (*cy_p64_image_digest_cb_t)(uint32_t processed, uint32_t total, void *arg);
+
+/** The completion callback of cy_p64_confirm_image_start(). It is called from
+ * cy_p64_confirm_image_poll() when the Image OK flag is written.
+ *
+ * \param status      \ref CY_P64_SUCCESS or the error code of the flash operation.
+ * \param arg         The user argument passed to cy_p64_confirm_image_start().
+ */
+typedef void (*cy_p64_image_confirm_cb_t)(cy_p64_error_codes_t status, void *arg);
+
+/** The row-buffered flash writer. The writes to the same flash row are merged
+ * in RAM and the row is programmed once, when a write to another row comes or
+ * cy_p64_flash_writer_flush() is called. Initialize it with
+ * cy_p64_flash_writer_init(), do not access the fields directly. */
+typedef struct
+{
+    /** The address of the buffered row */
+    uint32_t row_addr;
+    /** The row buffer holds the row at \ref row_addr */
+    bool loaded;
+    /** The row buffer differs from flash */
+    bool dirty;
+    /** The row buffer */
+    uint32_t row[CY_FLASH_SIZEOF_ROW_LONG_UNITS];
+} cy_p64_flash_writer_t;
+
+/** The streaming upgrade slot writer, see cy_p64_image_upgrade_begin().
+ * Do not access the fields directly. */
+typedef struct
+{
+    /** The start address of the slot */
+    uint32_t slot_addr;
+    /** The size of the slot */
+    uint32_t slot_size;
+    /** The address of the next row to program */
+    uint32_t write_addr;
+    /** The end of the erased area */
+    uint32_t erased_end;
+    /** The number of bytes in the current row buffer */
+    uint32_t fill;
+    /** The index of the current row buffer */
+    uint32_t cur;
+    /** A row is being programmed from the other buffer */
+    bool busy;
+    /** The hash of the received data */
+    cy_p64_psa_hash_operation_t hash;
+    /** Two row buffers: one is filled while the other is programmed */
+    uint32_t row[2u][CY_FLASH_SIZEOF_ROW_LONG_UNITS];
+} cy_p64_image_upgrade_t;
+
+/** \} */
+
+void cy_p64_flash_writer_init(cy_p64_flash_writer_t *writer);
+cy_p64_error_codes_t cy_p64_flash_writer_write(cy_p64_flash_writer_t *writer,
+                                               uint32_t address,
+                                               const uint8_t *data,
+                                               uint32_t size);
+cy_p64_error_codes_t cy_p64_flash_writer_flush(cy_p64_flash_writer_t *writer);
 cy_p64_error_codes_t cy_p64_confirm_image(uint32_t image_start, uint32_t image_size);
 bool cy_p64_is_image_confirmed(uint32_t image_start, uint32_t image_size);
+cy_p64_error_codes_t cy_p64_confirm_image_start(uint32_t image_start,
+                                                uint32_t image_size,
+                                                cy_p64_image_confirm_cb_t callback,
+                                                void *cb_arg);
+bool cy_p64_confirm_image_poll(void);
+cy_p64_error_codes_t cy_p64_image_digest(uint32_t address,
+                                         uint32_t size,
+                                         cy_p64_psa_algorithm_t alg,
+                                         uint8_t *hash,
+                                         size_t hash_size,
+                                         size_t *hash_length,
+                                         cy_p64_image_digest_cb_t callback,
+                                         void *cb_arg);
+cy_p64_error_codes_t cy_p64_image_upgrade_begin(cy_p64_image_upgrade_t *ctx,
+                                                uint32_t slot_addr,
+                                                uint32_t slot_size,
+                                                cy_p64_psa_algorithm_t alg);
+cy_p64_error_codes_t cy_p64_image_upgrade_write(cy_p64_image_upgrade_t *ctx,
+                                                const uint8_t *data,
+                                                uint32_t length);
+cy_p64_error_codes_t cy_p64_image_upgrade_finish(cy_p64_image_upgrade_t *ctx,
+                                                 const uint8_t *hash,
+                                                 size_t hash_length,
+                                                 bool permanent);
+void cy_p64_image_upgrade_abort(cy_p64_image_upgrade_t *ctx);
+cy_p64_error_codes_t cy_p64_image_validate(const cy_p64_cJSON *json, uint32_t image_id);
+cy_p64_error_codes_t cy_p64_image_install_encrypted(uint32_t dst_address,
+                                                    const uint8_t *src,
+                                                    uint32_t size,
+                                                    cy_p64_psa_key_handle_t key,
+                                                    cy_p64_psa_algorithm_t alg,
+                                                    const uint8_t *iv,
+                                                    size_t iv_length);
 
 #endif /* CY_P64_IMAGE_H */
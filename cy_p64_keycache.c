@@ -0,0 +1,516 @@
+/***************************************************************************//**
+* \file cy_p64_keycache.c
+* \version 1.0
+*
+* \brief
+* This is the source code file for the Secure FlashBoot key caching functions.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+/*******************************************************************************
+* Key cache Prototypes
+****************************************************************************//**
+*
+* \defgroup keycache     Key cache
+*
+* \brief
+*  This library caches keys of the Secure FlashBoot key storage to reduce
+*  the number of syscalls and the cost of the repeated operations.
+*
+*  The key handle cache keeps the handles returned by
+*  cy_p64_keys_load_key_handle() together with the key attributes, so the
+*  repeated operations with the same key do not load the handle and read the
+*  attributes again. The least recently used entry without references is
+*  replaced when the cache is full.
+*
+*  The public key cache exports the public key of a key pair slot once and
+*  imports it as a public key, so following cy_p64_psa_verify_hash() calls
+*  do not calculate the public key from the private key on each verification.
+*
+* \{
+*   \defgroup keycache_api Functions
+*   \defgroup keycache_macros Macros
+* \}
+*******************************************************************************/
+
+#include <stdbool.h>
+#include "cy_p64_keycache.h"
+#include "cy_p64_syscalls.h"
+
+
+typedef struct
+{
+    cy_p64_key_slot_t key_id;           /* The cached slot, CY_P64_KEY_SLOT_NA for the free entry */
+    cy_p64_psa_key_handle_t handle;     /* The handle loaded from the slot */
+    uint32_t ref_count;                 /* The number of not released cy_p64_key_handle_cache_acquire() calls */
+    uint32_t last_use;                  /* The value of the use counter on the last access, for LRU replacement */
+    cy_p64_psa_key_attributes_t attributes; /* The key attributes read once on load */
+} cy_p64_key_handle_cache_entry_t;
+
+typedef struct
+{
+    cy_p64_key_slot_t key_id;           /* The cached slot, CY_P64_KEY_SLOT_NA for the free entry */
+    cy_p64_psa_key_handle_t handle;     /* The handle used for verification */
+    bool imported;                      /* The handle is imported by the cache and must be destroyed */
+} cy_p64_pubkey_cache_entry_t;
+
+static cy_p64_key_handle_cache_entry_t cy_p64_key_handle_cache[CY_P64_KEY_HANDLE_CACHE_SIZE];
+static uint32_t cy_p64_key_handle_cache_size = 0u;
+static uint32_t cy_p64_key_handle_cache_use = 0u;
+
+static cy_p64_pubkey_cache_entry_t cy_p64_pubkey_cache[CY_P64_PUBKEY_CACHE_SIZE];
+static uint32_t cy_p64_pubkey_cache_victim = 0u;
+
+
+/*******************************************************************************
+* Function Name: cy_p64_key_handle_cache_find
+****************************************************************************//**
+* Finds the key handle cache entry of the key slot.
+*
+* \param[in] key_id     The slot number in SFB key storage.
+* \return               The pointer to the entry or NULL if the slot is not cached.
+*******************************************************************************/
+static cy_p64_key_handle_cache_entry_t *cy_p64_key_handle_cache_find(cy_p64_key_slot_t key_id)
+{
+    cy_p64_key_handle_cache_entry_t *entry = NULL;
+    uint32_t i;
+
+    for(i = 0u; i < cy_p64_key_handle_cache_size; i++)
+    {
+        if(cy_p64_key_handle_cache[i].key_id == key_id)
+        {
+            entry = &cy_p64_key_handle_cache[i];
+            break;
+        }
+    }
+
+    return entry;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_key_handle_cache_victim
+****************************************************************************//**
+* Finds the entry for a new key: the free entry or the least recently used
+* entry without references.
+*
+* \return   The pointer to the entry or NULL if all entries are referenced.
+*******************************************************************************/
+static cy_p64_key_handle_cache_entry_t *cy_p64_key_handle_cache_victim(void)
+{
+    cy_p64_key_handle_cache_entry_t *entry = NULL;
+    uint32_t i;
+
+    if(cy_p64_key_handle_cache_size == 0u)
+    {
+        /* Limit the cache size to the number of SFB key slots, read once */
+        cy_p64_key_handle_cache_size = cy_p64_keys_get_count();
+        if((cy_p64_key_handle_cache_size == 0u) ||
+           (cy_p64_key_handle_cache_size > CY_P64_KEY_HANDLE_CACHE_SIZE))
+        {
+            cy_p64_key_handle_cache_size = CY_P64_KEY_HANDLE_CACHE_SIZE;
+        }
+    }
+
+    for(i = 0u; i < cy_p64_key_handle_cache_size; i++)
+    {
+        if(cy_p64_key_handle_cache[i].key_id == CY_P64_KEY_SLOT_NA)
+        {
+            entry = &cy_p64_key_handle_cache[i];
+            break;
+        }
+        if((cy_p64_key_handle_cache[i].ref_count == 0u) &&
+           ((entry == NULL) || (cy_p64_key_handle_cache[i].last_use < entry->last_use)))
+        {
+            entry = &cy_p64_key_handle_cache[i];
+        }
+    }
+
+    return entry;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_pubkey_cache_release
+****************************************************************************//**
+* Frees the cache entry and destroys the imported key.
+*
+* \param[in] entry      The cache entry to free.
+*******************************************************************************/
+static void cy_p64_pubkey_cache_release(cy_p64_pubkey_cache_entry_t *entry)
+{
+    if((entry->key_id != CY_P64_KEY_SLOT_NA) && entry->imported)
+    {
+        (void)cy_p64_psa_destroy_key(entry->handle);
+    }
+    entry->key_id = CY_P64_KEY_SLOT_NA;
+    entry->handle = 0u;
+    entry->imported = false;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_pubkey_cache_load
+****************************************************************************//**
+* Loads the key from the slot. The public key of a key pair is exported and
+* imported as a separate public key handle.
+*
+* \param[in] key_id     The slot number in SFB key storage.
+* \param[out] entry     The cache entry to fill.
+* \return               \ref CY_P64_PSA_SUCCESS for success or error code.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_pubkey_cache_load(cy_p64_key_slot_t key_id,
+                                                    cy_p64_pubkey_cache_entry_t *entry)
+{
+    cy_p64_psa_status_t status;
+    cy_p64_psa_key_handle_t slot_handle = 0u;
+    const cy_p64_psa_key_attributes_t *attributes = NULL;
+    cy_p64_psa_key_attributes_t pub_attributes = CY_P64_PSA_KEY_ATTRIBUTES_INIT;
+    uint8_t pub_key[CY_P64_PUBKEY_CACHE_KEY_MAX_SIZE];
+    size_t pub_key_length = 0u;
+
+    status = cy_p64_key_handle_cache_acquire(key_id, &slot_handle, &attributes);
+
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        if(CY_P64_PSA_KEY_TYPE_IS_KEY_PAIR(cy_p64_psa_get_key_type(attributes)))
+        {
+            status = cy_p64_psa_export_public_key(slot_handle, pub_key, sizeof(pub_key), &pub_key_length);
+            if(status == CY_P64_PSA_SUCCESS)
+            {
+                cy_p64_psa_set_key_type(&pub_attributes,
+                    CY_P64_PSA_KEY_TYPE_PUBLIC_KEY_OF_KEY_PAIR(cy_p64_psa_get_key_type(attributes)));
+                cy_p64_psa_set_key_bits(&pub_attributes, cy_p64_psa_get_key_bits(attributes));
+                cy_p64_psa_set_key_algorithm(&pub_attributes, cy_p64_psa_get_key_algorithm(attributes));
+                cy_p64_psa_set_key_usage_flags(&pub_attributes, CY_P64_PSA_KEY_USAGE_VERIFY_HASH);
+
+                status = cy_p64_psa_import_key(&pub_attributes, pub_key, pub_key_length, &entry->handle);
+                entry->imported = (status == CY_P64_PSA_SUCCESS);
+            }
+        }
+        else
+        {
+            /* The slot already holds a public key, so its handle is cached as is */
+            entry->handle = slot_handle;
+            entry->imported = false;
+        }
+
+        cy_p64_key_handle_cache_release(key_id);
+    }
+
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        entry->key_id = key_id;
+    }
+    else
+    {
+        entry->key_id = CY_P64_KEY_SLOT_NA;
+    }
+
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Prototypes
+****************************************************************************//**
+*
+*  \addtogroup keycache_api
+*
+*  \{
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: cy_p64_key_handle_cache_acquire
+****************************************************************************//**
+* Returns the handle and the attributes of the key stored in the key slot.
+* On the first call for the slot, the handle is loaded with
+* cy_p64_keys_load_key_handle() and the attributes are read with
+* cy_p64_psa_get_key_attributes(). The following calls return the cached values
+* without any syscall.
+* Each successful call must be paired with cy_p64_key_handle_cache_release(),
+* the referenced entries are never replaced.
+*
+* \param[in] key_id      The slot number in SFB key storage.
+* \param[out] handle     The key handle.
+* \param[out] attributes The pointer to the cached key attributes, can be NULL.
+*                        It is valid until the entry is released.
+*
+* \retval #CY_P64_PSA_SUCCESS
+* \retval #CY_P64_PSA_ERROR_INVALID_ARGUMENT
+* \retval #CY_P64_PSA_ERROR_DOES_NOT_EXIST
+* \retval #CY_P64_PSA_ERROR_INSUFFICIENT_MEMORY
+*         All cache entries are referenced.
+*******************************************************************************/
+cy_p64_psa_status_t cy_p64_key_handle_cache_acquire(cy_p64_key_slot_t key_id,
+                                                    cy_p64_psa_key_handle_t *handle,
+                                                    const cy_p64_psa_key_attributes_t **attributes)
+{
+    cy_p64_psa_status_t status = CY_P64_PSA_SUCCESS;
+    cy_p64_key_handle_cache_entry_t *entry;
+
+    if((handle == NULL) || (key_id == CY_P64_KEY_SLOT_NA))
+    {
+        status = CY_P64_PSA_ERROR_INVALID_ARGUMENT;
+    }
+    else
+    {
+        entry = cy_p64_key_handle_cache_find(key_id);
+        if(entry == NULL)
+        {
+            entry = cy_p64_key_handle_cache_victim();
+            if(entry == NULL)
+            {
+                status = CY_P64_PSA_ERROR_INSUFFICIENT_MEMORY;
+            }
+            else
+            {
+                entry->key_id = CY_P64_KEY_SLOT_NA;
+                entry->ref_count = 0u;
+                entry->attributes = cy_p64_psa_key_attributes_init();
+
+                status = cy_p64_keys_load_key_handle(key_id, &entry->handle);
+                if(status == CY_P64_PSA_SUCCESS)
+                {
+                    status = cy_p64_psa_get_key_attributes(entry->handle, &entry->attributes);
+                }
+                if(status == CY_P64_PSA_SUCCESS)
+                {
+                    entry->key_id = key_id;
+                }
+                else
+                {
+                    entry = NULL;
+                }
+            }
+        }
+
+        if(entry != NULL)
+        {
+            entry->ref_count++;
+            entry->last_use = ++cy_p64_key_handle_cache_use;
+            *handle = entry->handle;
+            if(attributes != NULL)
+            {
+                *attributes = &entry->attributes;
+            }
+        }
+    }
+
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_key_handle_cache_release
+****************************************************************************//**
+* Releases the reference taken by cy_p64_key_handle_cache_acquire().
+* The handle stays in the cache for the following calls.
+*
+* \param[in] key_id     The slot number in SFB key storage.
+*******************************************************************************/
+void cy_p64_key_handle_cache_release(cy_p64_key_slot_t key_id)
+{
+    cy_p64_key_handle_cache_entry_t *entry = cy_p64_key_handle_cache_find(key_id);
+
+    if((entry != NULL) && (entry->ref_count > 0u))
+    {
+        entry->ref_count--;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_key_handle_cache_invalidate
+****************************************************************************//**
+* Removes the key slot from the key handle cache. The handles obtained before
+* must not be used after this call.
+*
+* \note The cached handle is not closed by cy_p64_keys_close_key(), because it
+* destroys the key stored in the slot.
+*
+* \param[in] key_id     The slot number in SFB key storage.
+*******************************************************************************/
+void cy_p64_key_handle_cache_invalidate(cy_p64_key_slot_t key_id)
+{
+    cy_p64_key_handle_cache_entry_t *entry = cy_p64_key_handle_cache_find(key_id);
+
+    if(entry != NULL)
+    {
+        entry->key_id = CY_P64_KEY_SLOT_NA;
+        entry->ref_count = 0u;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_keycache_invalidate
+****************************************************************************//**
+* Removes the key slot from the key handle cache and from the public key cache.
+* It is called by cy_p64_keys_store_key() and cy_p64_keys_close_key(), call it
+* explicitly if the slot is changed by other means.
+*
+* \param[in] key_id     The slot number in SFB key storage.
+*******************************************************************************/
+void cy_p64_keycache_invalidate(cy_p64_key_slot_t key_id)
+{
+    cy_p64_pubkey_cache_invalidate(key_id);
+    cy_p64_key_handle_cache_invalidate(key_id);
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_pubkey_cache_get_handle
+****************************************************************************//**
+* Returns the handle of the public key that corresponds to the key slot.
+* On the first call for the slot, the public key of a key pair is exported with
+* cy_p64_psa_export_public_key() and imported as a public key, the following
+* calls return the cached handle without any syscall.
+* When the cache is full, the oldest entry is replaced.
+*
+* \note The returned handle is valid until the entry is invalidated or replaced,
+* do not destroy it.
+*
+* \param[in] key_id     The slot number in SFB key storage, for example
+*                       #CY_P64_KEY_SLOT_DEVICE_ECDSA or #CY_P64_KEY_SLOT_OEM.
+* \param[out] handle    The handle of the public key.
+*
+* \retval #CY_P64_PSA_SUCCESS
+* \retval #CY_P64_PSA_ERROR_INVALID_ARGUMENT
+* \retval #CY_P64_PSA_ERROR_DOES_NOT_EXIST
+* \retval #CY_P64_PSA_ERROR_INSUFFICIENT_MEMORY
+*         SFB has no free volatile key slot for the imported public key.
+*******************************************************************************/
+cy_p64_psa_status_t cy_p64_pubkey_cache_get_handle(cy_p64_key_slot_t key_id,
+                                                   cy_p64_psa_key_handle_t *handle)
+{
+    cy_p64_psa_status_t status = CY_P64_PSA_ERROR_DOES_NOT_EXIST;
+    cy_p64_pubkey_cache_entry_t *entry = NULL;
+    uint32_t i;
+
+    if((handle == NULL) || (key_id == CY_P64_KEY_SLOT_NA))
+    {
+        status = CY_P64_PSA_ERROR_INVALID_ARGUMENT;
+    }
+    else
+    {
+        for(i = 0u; i < CY_P64_PUBKEY_CACHE_SIZE; i++)
+        {
+            if(cy_p64_pubkey_cache[i].key_id == key_id)
+            {
+                *handle = cy_p64_pubkey_cache[i].handle;
+                status = CY_P64_PSA_SUCCESS;
+                break;
+            }
+            if((entry == NULL) && (cy_p64_pubkey_cache[i].key_id == CY_P64_KEY_SLOT_NA))
+            {
+                entry = &cy_p64_pubkey_cache[i];
+            }
+        }
+
+        if(status != CY_P64_PSA_SUCCESS)
+        {
+            if(entry == NULL)
+            {
+                entry = &cy_p64_pubkey_cache[cy_p64_pubkey_cache_victim];
+                cy_p64_pubkey_cache_victim = (cy_p64_pubkey_cache_victim + 1u) % CY_P64_PUBKEY_CACHE_SIZE;
+                cy_p64_pubkey_cache_release(entry);
+            }
+
+            status = cy_p64_pubkey_cache_load(key_id, entry);
+            if(status == CY_P64_PSA_SUCCESS)
+            {
+                *handle = entry->handle;
+            }
+        }
+    }
+
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_pubkey_cache_verify_hash
+****************************************************************************//**
+* Verifies the signature of a hash with the cached public key of the key slot.
+* It is the same as cy_p64_psa_verify_hash(), but it does not need the public
+* key calculation when the slot holds a key pair.
+*
+* \param[in] key_id            The slot number in SFB key storage.
+* \param[in] alg               A signature algorithm compatible with the key.
+* \param[in] hash              The hash whose signature is to be verified.
+* \param[in] hash_length       The size of the \p hash buffer in bytes.
+* \param[in] signature         The buffer containing the signature to verify.
+* \param[in] signature_length  The size of the \p signature buffer in bytes.
+*
+* \retval #CY_P64_PSA_SUCCESS
+*         The signature is valid.
+* \retval #CY_P64_PSA_ERROR_INVALID_SIGNATURE
+* \retval #CY_P64_PSA_ERROR_INVALID_ARGUMENT
+* \retval #CY_P64_PSA_ERROR_DOES_NOT_EXIST
+*******************************************************************************/
+cy_p64_psa_status_t cy_p64_pubkey_cache_verify_hash(cy_p64_key_slot_t key_id,
+                                                    cy_p64_psa_algorithm_t alg,
+                                                    const uint8_t *hash,
+                                                    size_t hash_length,
+                                                    const uint8_t *signature,
+                                                    size_t signature_length)
+{
+    cy_p64_psa_status_t status;
+    cy_p64_psa_key_handle_t handle = 0u;
+
+    status = cy_p64_pubkey_cache_get_handle(key_id, &handle);
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_psa_verify_hash(handle, alg, hash, hash_length, signature, signature_length);
+    }
+
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_pubkey_cache_invalidate
+****************************************************************************//**
+* Removes the key slot from the public key cache and destroys the imported key.
+*
+* \param[in] key_id     The slot number in SFB key storage.
+*******************************************************************************/
+void cy_p64_pubkey_cache_invalidate(cy_p64_key_slot_t key_id)
+{
+    uint32_t i;
+
+    for(i = 0u; i < CY_P64_PUBKEY_CACHE_SIZE; i++)
+    {
+        if(cy_p64_pubkey_cache[i].key_id == key_id)
+        {
+            cy_p64_pubkey_cache_release(&cy_p64_pubkey_cache[i]);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_pubkey_cache_invalidate_all
+****************************************************************************//**
+* Removes all entries from the public key cache and destroys the imported keys.
+*******************************************************************************/
+void cy_p64_pubkey_cache_invalidate_all(void)
+{
+    uint32_t i;
+
+    for(i = 0u; i < CY_P64_PUBKEY_CACHE_SIZE; i++)
+    {
+        cy_p64_pubkey_cache_release(&cy_p64_pubkey_cache[i]);
+    }
+    cy_p64_pubkey_cache_victim = 0u;
+}
+
+/** \} */
@@ -0,0 +1,66 @@
+/***************************************************************************//**
+* \file cy_p64_keycache.h
+* \version 1.0
+*
+* \brief
+* This is the header file for the Secure FlashBoot key caching functions.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef CY_P64_KEYCACHE_H
+#define CY_P64_KEYCACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "cy_p64_psacrypto.h"
+
+/** \addtogroup keycache_macros
+ * \{
+ */
+
+/** The number of public verification keys kept by the cache.
+ * Each entry created from a key pair slot holds one imported key in the
+ * Secure FlashBoot volatile key storage. */
+#ifndef CY_P64_PUBKEY_CACHE_SIZE
+#define CY_P64_PUBKEY_CACHE_SIZE            (2u)
+#endif /* CY_P64_PUBKEY_CACHE_SIZE */
+
+/** The maximum number of key handles kept by the key handle cache.
+ * The effective size is also limited by the number of the Secure FlashBoot
+ * key slots returned by cy_p64_keys_get_count(). */
+#ifndef CY_P64_KEY_HANDLE_CACHE_SIZE
+#define CY_P64_KEY_HANDLE_CACHE_SIZE        (4u)
+#endif /* CY_P64_KEY_HANDLE_CACHE_SIZE */
+
+/** The maximum size of the exported public key: secp256r1 uncompressed point */
+#define CY_P64_PUBKEY_CACHE_KEY_MAX_SIZE    (CY_P64_PSA_KEY_EXPORT_ECC_PUBLIC_KEY_MAX_SIZE(256u))
+
+/** \} */
+
+/* Public APIs */
+cy_p64_psa_status_t cy_p64_key_handle_cache_acquire(cy_p64_key_slot_t key_id,
+                                                    cy_p64_psa_key_handle_t *handle,
+                                                    const cy_p64_psa_key_attributes_t **attributes);
+void cy_p64_key_handle_cache_release(cy_p64_key_slot_t key_id);
+void cy_p64_key_handle_cache_invalidate(cy_p64_key_slot_t key_id);
+void cy_p64_keycache_invalidate(cy_p64_key_slot_t key_id);
+
+cy_p64_psa_status_t cy_p64_pubkey_cache_get_handle(cy_p64_key_slot_t key_id,
+                                                   cy_p64_psa_key_handle_t *handle);
+cy_p64_psa_status_t cy_p64_pubkey_cache_verify_hash(cy_p64_key_slot_t key_id,
+                                                    cy_p64_psa_algorithm_t alg,
+                                                    const uint8_t *hash,
+                                                    size_t hash_length,
+                                                    const uint8_t *signature,
+                                                    size_t signature_length);
+void cy_p64_pubkey_cache_invalidate(cy_p64_key_slot_t key_id);
+void cy_p64_pubkey_cache_invalidate_all(void);
+
+#endif /* CY_P64_KEYCACHE_H */
@@ -0,0 +1,362 @@
+/***************************************************************************//**
+* \file cy_p64_keyschedule.c
+* \version 1.0
+*
+* \brief
+* This is the source code file for the one-shot key schedule functions.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+/*******************************************************************************
+* Key schedule Prototypes
+****************************************************************************//**
+*
+* \defgroup keyschedule     Key schedule
+*
+* \brief
+*  This library derives a set of keys and byte strings with one call.
+*  The inputs and the outputs are described by the lists of
+*  \ref cy_p64_key_schedule_input_t and \ref cy_p64_key_schedule_output_t.
+*  The lists are validated before the first syscall, so a bad list does not
+*  leave the half-derived keys in the Secure FlashBoot key storage.
+*
+*  Example: derive an AES key and a 12-byte IV from the ECDH shared secret.
+*  \code{c}
+*  const cy_p64_key_schedule_input_t inputs[] =
+*  {
+*      { CY_P64_KEY_SCHEDULE_INPUT_BYTES, CY_P64_PSA_KEY_DERIVATION_INPUT_SALT, 0u, salt, sizeof(salt) },
+*      { CY_P64_KEY_SCHEDULE_INPUT_AGREEMENT, CY_P64_PSA_KEY_DERIVATION_INPUT_SECRET, ecdh_key, peer, sizeof(peer) },
+*      { CY_P64_KEY_SCHEDULE_INPUT_BYTES, CY_P64_PSA_KEY_DERIVATION_INPUT_INFO, 0u, info, sizeof(info) },
+*  };
+*  const cy_p64_key_schedule_output_t outputs[] =
+*  {
+*      { &aes_attributes, &aes_key, NULL, 0u },
+*      { NULL, NULL, iv, sizeof(iv) },
+*  };
+*
+*  status = cy_p64_key_schedule_derive(
+*      CY_P64_PSA_ALG_KEY_AGREEMENT(CY_P64_PSA_ALG_ECDH, CY_P64_PSA_ALG_HKDF(CY_P64_PSA_ALG_SHA_256)),
+*      inputs, 3u, outputs, 2u);
+*  \endcode
+*
+* \{
+*   \defgroup keyschedule_api Functions
+*   \defgroup keyschedule_macros Macros
+*   \defgroup keyschedule_t Data Structures
+* \}
+*******************************************************************************/
+
+#include <string.h>
+#include "cy_p64_keyschedule.h"
+
+
+/*******************************************************************************
+* Function Name: cy_p64_key_schedule_check_inputs
+****************************************************************************//**
+* Validates the input list.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_key_schedule_check_inputs(cy_p64_psa_algorithm_t alg,
+                                                            const cy_p64_key_schedule_input_t *inputs,
+                                                            size_t input_count)
+{
+    cy_p64_psa_status_t status = CY_P64_PSA_SUCCESS;
+    const cy_p64_key_schedule_input_t *input;
+    size_t i;
+
+    if((inputs == NULL) && (input_count > 0u))
+    {
+        status = CY_P64_PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    for(i = 0u; (i < input_count) && (status == CY_P64_PSA_SUCCESS); i++)
+    {
+        input = &inputs[i];
+        switch(input->type)
+        {
+            case CY_P64_KEY_SCHEDULE_INPUT_BYTES:
+                if((input->data == NULL) && (input->length > 0u))
+                {
+                    status = CY_P64_PSA_ERROR_INVALID_ARGUMENT;
+                }
+                break;
+            case CY_P64_KEY_SCHEDULE_INPUT_KEY:
+                if(input->key == 0u)
+                {
+                    status = CY_P64_PSA_ERROR_INVALID_HANDLE;
+                }
+                break;
+            case CY_P64_KEY_SCHEDULE_INPUT_AGREEMENT:
+                if(input->key == 0u)
+                {
+                    status = CY_P64_PSA_ERROR_INVALID_HANDLE;
+                }
+                else if((!CY_P64_PSA_ALG_IS_KEY_AGREEMENT(alg)) || (input->data == NULL) || (input->length == 0u))
+                {
+                    status = CY_P64_PSA_ERROR_INVALID_ARGUMENT;
+                }
+                else
+                {
+                    /* The input is valid */
+                }
+                break;
+            default:
+                status = CY_P64_PSA_ERROR_INVALID_ARGUMENT;
+                break;
+        }
+    }
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_key_schedule_check_outputs
+****************************************************************************//**
+* Validates the output list and checks that the total output fits in the HKDF
+* capacity.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_key_schedule_check_outputs(cy_p64_psa_algorithm_t kdf_alg,
+                                                             const cy_p64_key_schedule_output_t *outputs,
+                                                             size_t output_count)
+{
+    cy_p64_psa_status_t status = CY_P64_PSA_SUCCESS;
+    const cy_p64_key_schedule_output_t *output;
+    size_t total = 0u;
+    size_t length;
+    size_t i;
+
+    if((outputs == NULL) || (output_count == 0u))
+    {
+        status = CY_P64_PSA_ERROR_INVALID_ARGUMENT;
+    }
+
+    for(i = 0u; (i < output_count) && (status == CY_P64_PSA_SUCCESS); i++)
+    {
+        output = &outputs[i];
+        if(output->attributes != NULL)
+        {
+            length = CY_P64_PSA_BITS_TO_BYTES(cy_p64_psa_get_key_bits(output->attributes));
+            if((output->handle == NULL) || (length == 0u))
+            {
+                status = CY_P64_PSA_ERROR_INVALID_ARGUMENT;
+            }
+        }
+        else
+        {
+            length = output->length;
+            if((output->data == NULL) || (length == 0u))
+            {
+                status = CY_P64_PSA_ERROR_INVALID_ARGUMENT;
+            }
+        }
+
+        if((status == CY_P64_PSA_SUCCESS) && ((total + length) < total))
+        {
+            status = CY_P64_PSA_ERROR_INVALID_ARGUMENT;
+        }
+        total += length;
+    }
+
+    if((status == CY_P64_PSA_SUCCESS) && CY_P64_PSA_ALG_IS_HKDF(kdf_alg))
+    {
+        if(CY_P64_PSA_HASH_SIZE(CY_P64_PSA_ALG_HKDF_GET_HASH(kdf_alg)) == 0u)
+        {
+            status = CY_P64_PSA_ERROR_NOT_SUPPORTED;
+        }
+        else if(total > CY_P64_KEY_SCHEDULE_HKDF_MAX_SIZE(CY_P64_PSA_ALG_HKDF_GET_HASH(kdf_alg)))
+        {
+            status = CY_P64_PSA_ERROR_INSUFFICIENT_DATA;
+        }
+        else
+        {
+            /* The output fits in the capacity */
+        }
+    }
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_key_schedule_feed
+****************************************************************************//**
+* Passes the inputs to the key derivation operation. The empty HKDF salt is
+* skipped, it is equal to the omitted one. The info is always passed, even
+* when empty, because the HKDF output requires the info step.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_key_schedule_feed(cy_p64_psa_key_derivation_operation_t *operation,
+                                                    cy_p64_psa_algorithm_t kdf_alg,
+                                                    const cy_p64_key_schedule_input_t *inputs,
+                                                    size_t input_count)
+{
+    cy_p64_psa_status_t status = CY_P64_PSA_SUCCESS;
+    const cy_p64_key_schedule_input_t *input;
+    size_t i;
+
+    for(i = 0u; (i < input_count) && (status == CY_P64_PSA_SUCCESS); i++)
+    {
+        input = &inputs[i];
+        if(input->type == CY_P64_KEY_SCHEDULE_INPUT_KEY)
+        {
+            status = cy_p64_psa_key_derivation_inp_key(operation, input->step, input->key);
+        }
+        else if(input->type == CY_P64_KEY_SCHEDULE_INPUT_AGREEMENT)
+        {
+            status = cy_p64_psa_key_derivation_key_agreement(operation, input->step, input->key,
+                                                             input->data, input->length);
+        }
+        else if((input->length > 0u) || (!CY_P64_PSA_ALG_IS_HKDF(kdf_alg)) ||
+                (input->step != CY_P64_PSA_KEY_DERIVATION_INPUT_SALT))
+        {
+            status = cy_p64_psa_key_derivation_inp_bytes(operation, input->step, input->data, input->length);
+        }
+        else
+        {
+            /* The empty HKDF salt is skipped */
+        }
+    }
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_key_schedule_cleanup
+****************************************************************************//**
+* Destroys the derived keys and clears the derived bytes of the first
+* \p count outputs.
+*******************************************************************************/
+static void cy_p64_key_schedule_cleanup(const cy_p64_key_schedule_output_t *outputs, size_t count)
+{
+    const cy_p64_key_schedule_output_t *output;
+    size_t i;
+
+    for(i = 0u; i < count; i++)
+    {
+        output = &outputs[i];
+        if(output->attributes != NULL)
+        {
+            if(*output->handle != 0u)
+            {
+                (void)cy_p64_psa_destroy_key(*output->handle);
+                *output->handle = 0u;
+            }
+        }
+        else
+        {
+            (void)memset(output->data, 0, output->length);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Prototypes
+****************************************************************************//**
+*
+*  \addtogroup keyschedule_api
+*
+*  \{
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: cy_p64_key_schedule_derive
+****************************************************************************//**
+* Runs the complete key derivation: setup, all inputs, all outputs and abort.
+*
+* The lists are validated first. The total output size is checked against
+* the HKDF capacity, the key output takes the bytes of its key bits.
+* Consecutive bytes outputs that are adjacent in memory are read with one
+* syscall. The empty HKDF salt input is skipped, the empty info is passed.
+*
+* On failure the keys derived so far are destroyed, their handles set to 0,
+* and the bytes outputs are cleared.
+*
+* \param[in] alg            The key derivation or key agreement algorithm.
+* \param[in] inputs         The list of the inputs in the order required by
+*                           the algorithm.
+* \param[in] input_count    The number of the inputs.
+* \param[in] outputs        The list of the outputs.
+* \param[in] output_count   The number of the outputs.
+* \return     \ref CY_P64_PSA_SUCCESS for success or the error code.
+*******************************************************************************/
+cy_p64_psa_status_t cy_p64_key_schedule_derive(cy_p64_psa_algorithm_t alg,
+                                               const cy_p64_key_schedule_input_t *inputs,
+                                               size_t input_count,
+                                               const cy_p64_key_schedule_output_t *outputs,
+                                               size_t output_count)
+{
+    cy_p64_psa_status_t status = CY_P64_PSA_SUCCESS;
+    cy_p64_psa_key_derivation_operation_t operation = CY_P64_PSA_KEY_DERIVATION_OPERATION_INIT;
+    cy_p64_psa_algorithm_t kdf_alg = alg;
+    const cy_p64_key_schedule_output_t *output;
+    size_t length;
+    size_t done = 0u;
+    size_t i;
+
+    if(CY_P64_PSA_ALG_IS_KEY_AGREEMENT(alg))
+    {
+        kdf_alg = CY_P64_PSA_ALG_KEY_AGREEMENT_GET_KDF(alg);
+    }
+    if(!CY_P64_PSA_ALG_IS_KEY_DERIVATION(kdf_alg))
+    {
+        status = CY_P64_PSA_ERROR_INVALID_ARGUMENT;
+    }
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_key_schedule_check_inputs(alg, inputs, input_count);
+    }
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_key_schedule_check_outputs(kdf_alg, outputs, output_count);
+    }
+
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        status = cy_p64_psa_key_derivation_setup(&operation, alg);
+        if(status == CY_P64_PSA_SUCCESS)
+        {
+            status = cy_p64_key_schedule_feed(&operation, kdf_alg, inputs, input_count);
+
+            while((done < output_count) && (status == CY_P64_PSA_SUCCESS))
+            {
+                output = &outputs[done];
+                if(output->attributes != NULL)
+                {
+                    *output->handle = 0u;
+                    status = cy_p64_psa_key_derivation_out_key(output->attributes, &operation, output->handle);
+                    done++;
+                }
+                else
+                {
+                    length = output->length;
+                    for(i = done + 1u; i < output_count; i++)
+                    {
+                        if((outputs[i].attributes != NULL) || (outputs[i].data != &output->data[length]))
+                        {
+                            break;
+                        }
+                        length += outputs[i].length;
+                    }
+                    status = cy_p64_psa_key_derivation_out_bytes(&operation, output->data, length);
+                    done = i;
+                }
+            }
+
+            (void)cy_p64_psa_key_derivation_abort(&operation);
+        }
+
+        if(status != CY_P64_PSA_SUCCESS)
+        {
+            cy_p64_key_schedule_cleanup(outputs, done);
+        }
+    }
+
+    return status;
+}
+
+/** \} */
@@ -0,0 +1,74 @@
+/***************************************************************************//**
+* \file cy_p64_keyschedule.h
+* \version 1.0
+*
+* \brief
+* This is the header file for the one-shot key schedule functions.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef CY_P64_KEYSCHEDULE_H
+#define CY_P64_KEYSCHEDULE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "cy_p64_psacrypto.h"
+
+/** \addtogroup keyschedule_macros
+ * \{
+ */
+
+/** The maximum output of HKDF with the given hash algorithm: 255 hash blocks */
+#define CY_P64_KEY_SCHEDULE_HKDF_MAX_SIZE(hash_alg)     (255u * CY_P64_PSA_HASH_SIZE(hash_alg))
+
+/** \} */
+
+/** \addtogroup keyschedule_t
+ * \{
+ */
+
+/** The type of the key schedule input */
+typedef enum
+{
+    CY_P64_KEY_SCHEDULE_INPUT_BYTES     = 0u,   /**< The data buffer, see cy_p64_psa_key_derivation_inp_bytes() */
+    CY_P64_KEY_SCHEDULE_INPUT_KEY       = 1u,   /**< The key, see cy_p64_psa_key_derivation_inp_key() */
+    CY_P64_KEY_SCHEDULE_INPUT_AGREEMENT = 2u,   /**< The private key and the peer public key in the data
+                                                 *   buffer, see cy_p64_psa_key_derivation_key_agreement() */
+} cy_p64_key_schedule_input_type_t;
+
+/** The key schedule input step */
+typedef struct
+{
+    cy_p64_key_schedule_input_type_t type;      /**< The type of the input */
+    cy_p64_psa_key_derivation_step_t step;      /**< The derivation step, e.g. CY_P64_PSA_KEY_DERIVATION_INPUT_SALT */
+    cy_p64_psa_key_handle_t key;                /**< The key handle for the KEY and AGREEMENT inputs */
+    const uint8_t *data;                        /**< The data for the BYTES input, the peer key for the AGREEMENT input */
+    size_t length;                              /**< The length of the data in bytes */
+} cy_p64_key_schedule_input_t;
+
+/** The key schedule output. The outputs are derived in the order of the list. */
+typedef struct
+{
+    const cy_p64_psa_key_attributes_t *attributes; /**< The attributes of the derived key, NULL for the bytes output */
+    cy_p64_psa_key_handle_t *handle;            /**< The handle of the derived key */
+    uint8_t *data;                              /**< The buffer for the bytes output */
+    size_t length;                              /**< The length of the bytes output */
+} cy_p64_key_schedule_output_t;
+
+/** \} */
+
+/* Public APIs */
+cy_p64_psa_status_t cy_p64_key_schedule_derive(cy_p64_psa_algorithm_t alg,
+                                               const cy_p64_key_schedule_input_t *inputs,
+                                               size_t input_count,
+                                               const cy_p64_key_schedule_output_t *outputs,
+                                               size_t output_count);
+
+#endif /* CY_P64_KEYSCHEDULE_H */
@@ -0,0 +1,458 @@
+/***************************************************************************//**
+* \file cy_p64_mcuboot.c
+* \version 1.0
+*
+* \brief
+* This is the source code file for the MCUboot image header and trailer parser.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+/*******************************************************************************
+* MCUboot parser Prototypes
+****************************************************************************//**
+*
+* \defgroup mcuboot     MCUboot image parser
+*
+* \brief
+*  This library parses the MCUboot image header, the TLV area and the slot
+*  trailer (magic, swap_info, copy_done, image_ok) directly in the memory
+*  mapped flash. cy_p64_mcuboot_scan_policy() returns the summary of all
+*  "BOOT" and "UPGRADE" slots of the provisioning policy image table.
+*
+*  The trailer layout is the one of the CypressBootloader swap mode: each
+*  field is aligned to 8 bytes from the slot end.
+*
+* \{
+*   \defgroup mcuboot_api Functions
+*   \defgroup mcuboot_macros Macros
+*   \defgroup mcuboot_t Data Structures
+* \}
+*******************************************************************************/
+
+#include <string.h>
+#include "cy_p64_mcuboot.h"
+#include "cy_p64_jwt_policy.h"
+#include "cy_p64_flash.h"
+
+/* The offsets of the trailer fields from the end of the slot */
+#define CY_P64_MCUBOOT_MAGIC_OFFS           (16u)
+#define CY_P64_MCUBOOT_IMAGE_OK_OFFS        (24u)
+#define CY_P64_MCUBOOT_COPY_DONE_OFFS       (32u)
+#define CY_P64_MCUBOOT_SWAP_INFO_OFFS       (40u)
+#define CY_P64_MCUBOOT_MAGIC_SIZE           (16u)
+
+/* The image header field offsets */
+#define CY_P64_MCUBOOT_HDR_LOAD_ADDR        (4u)
+#define CY_P64_MCUBOOT_HDR_HDR_SIZE         (8u)
+#define CY_P64_MCUBOOT_HDR_PROT_TLV_SIZE    (10u)
+#define CY_P64_MCUBOOT_HDR_IMG_SIZE         (12u)
+#define CY_P64_MCUBOOT_HDR_FLAGS            (16u)
+#define CY_P64_MCUBOOT_HDR_VERSION          (20u)
+
+/* The size of the TLV area info and of the TLV entry header */
+#define CY_P64_MCUBOOT_TLV_INFO_SIZE        (4u)
+#define CY_P64_MCUBOOT_TLV_HDR_SIZE         (4u)
+
+/* The trailer magic, as it is stored in flash */
+static const uint8_t cy_p64_mcuboot_magic[CY_P64_MCUBOOT_MAGIC_SIZE] =
+{
+    0x77u, 0xc2u, 0x95u, 0xf3u, 0x60u, 0xd2u, 0xefu, 0x7fu,
+    0x35u, 0x52u, 0x50u, 0x0fu, 0x2cu, 0xb6u, 0x79u, 0x80u
+};
+
+
+/*******************************************************************************
+* Function Name: cy_p64_mcuboot_get16
+****************************************************************************//**
+* Reads the little-endian 16-bit value at any alignment.
+*******************************************************************************/
+static uint32_t cy_p64_mcuboot_get16(uint32_t address)
+{
+    const uint8_t *p = cy_p64_flash_ptr(address);
+
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8u);
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_mcuboot_get32
+****************************************************************************//**
+* Reads the little-endian 32-bit value at any alignment.
+*******************************************************************************/
+static uint32_t cy_p64_mcuboot_get32(uint32_t address)
+{
+    return cy_p64_mcuboot_get16(address) | (cy_p64_mcuboot_get16(address + 2u) << 16u);
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_mcuboot_parse_header
+****************************************************************************//**
+* Parses the image header and checks that the payload and the TLV areas fit
+* into the slot.
+*******************************************************************************/
+static void cy_p64_mcuboot_parse_header(cy_p64_mcuboot_slot_t *slot)
+{
+    uint32_t addr = slot->address;
+    uint32_t end;
+    bool valid = false;
+
+    if(cy_p64_mcuboot_get32(addr) == CY_P64_MCUBOOT_IMAGE_MAGIC)
+    {
+        slot->load_addr = cy_p64_mcuboot_get32(addr + CY_P64_MCUBOOT_HDR_LOAD_ADDR);
+        slot->hdr_size = cy_p64_mcuboot_get16(addr + CY_P64_MCUBOOT_HDR_HDR_SIZE);
+        slot->prot_tlv_size = cy_p64_mcuboot_get16(addr + CY_P64_MCUBOOT_HDR_PROT_TLV_SIZE);
+        slot->img_size = cy_p64_mcuboot_get32(addr + CY_P64_MCUBOOT_HDR_IMG_SIZE);
+        slot->flags = cy_p64_mcuboot_get32(addr + CY_P64_MCUBOOT_HDR_FLAGS);
+        slot->version.major = *cy_p64_flash_ptr(addr + CY_P64_MCUBOOT_HDR_VERSION);
+        slot->version.minor = *cy_p64_flash_ptr(addr + CY_P64_MCUBOOT_HDR_VERSION + 1u);
+        slot->version.revision = (uint16_t)cy_p64_mcuboot_get16(addr + CY_P64_MCUBOOT_HDR_VERSION + 2u);
+        slot->version.build_num = cy_p64_mcuboot_get32(addr + CY_P64_MCUBOOT_HDR_VERSION + 4u);
+
+        /* The payload, the TLV areas and the trailer must fit into the slot */
+        end = slot->size - CY_P64_MCUBOOT_SWAP_INFO_OFFS;
+        if((slot->hdr_size >= CY_P64_MCUBOOT_HEADER_SIZE) && (slot->hdr_size <= end) &&
+           (slot->img_size <= (end - slot->hdr_size)) &&
+           (slot->prot_tlv_size <= (end - slot->hdr_size - slot->img_size)))
+        {
+            slot->tlv_offset = slot->hdr_size + slot->img_size + slot->prot_tlv_size;
+            valid = (slot->tlv_offset + CY_P64_MCUBOOT_TLV_INFO_SIZE) <= end;
+        }
+
+        if(valid && (slot->prot_tlv_size != 0u))
+        {
+            addr = slot->address + slot->hdr_size + slot->img_size;
+            valid = (cy_p64_mcuboot_get16(addr) == CY_P64_MCUBOOT_TLV_PROT_INFO_MAGIC) &&
+                    (cy_p64_mcuboot_get16(addr + 2u) == slot->prot_tlv_size);
+        }
+
+        if(valid)
+        {
+            addr = slot->address + slot->tlv_offset;
+            slot->tlv_size = cy_p64_mcuboot_get16(addr + 2u);
+            valid = (cy_p64_mcuboot_get16(addr) == CY_P64_MCUBOOT_TLV_INFO_MAGIC) &&
+                    (slot->tlv_size >= CY_P64_MCUBOOT_TLV_INFO_SIZE) &&
+                    (slot->tlv_size <= (end - slot->tlv_offset));
+        }
+    }
+
+    slot->header_valid = valid;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_mcuboot_tlv_search
+****************************************************************************//**
+* Looks for the TLV entry in one TLV area.
+*
+* \param[in] start      The address of the first entry.
+* \param[in] end        The end address of the area.
+* \param[in] type       The TLV type.
+* \param[out] address   The address of the entry value.
+* \param[out] length    The length of the entry value.
+* \return               true if the entry is found.
+*******************************************************************************/
+static bool cy_p64_mcuboot_tlv_search(uint32_t start, uint32_t end, uint8_t type,
+                                      uint32_t *address, uint32_t *length)
+{
+    uint32_t addr = start;
+    uint32_t len;
+    bool found = false;
+
+    while((!found) && (addr < end) && ((end - addr) >= CY_P64_MCUBOOT_TLV_HDR_SIZE))
+    {
+        len = cy_p64_mcuboot_get16(addr + 2u);
+        if(len > (end - addr - CY_P64_MCUBOOT_TLV_HDR_SIZE))
+        {
+            /* Broken entry, stop the search */
+            addr = end;
+        }
+        else if(*cy_p64_flash_ptr(addr) == type)
+        {
+            *address = addr + CY_P64_MCUBOOT_TLV_HDR_SIZE;
+            *length = len;
+            found = true;
+        }
+        else
+        {
+            addr += CY_P64_MCUBOOT_TLV_HDR_SIZE + len;
+        }
+    }
+
+    return found;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_mcuboot_get_item
+****************************************************************************//**
+* Gets the named member of the JSON object, returns NULL if it is absent.
+*******************************************************************************/
+static const cy_p64_cJSON *cy_p64_mcuboot_get_item(const cy_p64_cJSON *json, const char *name)
+{
+    const cy_p64_cJSON *item = NULL;
+
+    if(json != NULL)
+    {
+        item = cy_p64_cJSON_GetObjectItem(json, name);
+    }
+    return item;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_mcuboot_get_uint32
+****************************************************************************//**
+* Gets the number member of the JSON object.
+*******************************************************************************/
+static cy_p64_error_codes_t cy_p64_mcuboot_get_uint32(const cy_p64_cJSON *json, const char *name, uint32_t *value)
+{
+    cy_p64_error_codes_t ret = CY_P64_JWT_ERR_JSN_NONOBJ;
+    const cy_p64_cJSON *item = cy_p64_mcuboot_get_item(json, name);
+
+    if(item != NULL)
+    {
+        ret = cy_p64_json_get_uint32(item, value);
+    }
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Prototypes
+****************************************************************************//**
+*
+*  \addtogroup mcuboot_api
+*
+*  \{
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: cy_p64_mcuboot_slot_info
+****************************************************************************//**
+* Parses the image header and the trailer of the slot. The slot must be in
+* the memory mapped flash. Only the header, the TLV area info and the trailer
+* fields are read. A slot without a valid image is not an error, check
+* the header_valid field of the summary.
+*
+* \param[in] address        The start address of the slot.
+* \param[in] size           The size of the slot.
+* \param[out] slot          The slot summary. The image_id and upgrade fields
+*                           are cleared.
+* \return     \ref CY_P64_SUCCESS for success or error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_mcuboot_slot_info(uint32_t address, uint32_t size, cy_p64_mcuboot_slot_t *slot)
+{
+    cy_p64_error_codes_t ret = CY_P64_SUCCESS;
+    const uint8_t *magic;
+    uint32_t i;
+    bool erased = true;
+
+    if(slot == NULL)
+    {
+        ret = CY_P64_INVALID_OUT_PAR;
+    }
+    else if((size < (CY_P64_MCUBOOT_HEADER_SIZE + CY_P64_MCUBOOT_SWAP_INFO_OFFS)) ||
+            (address > (UINT32_MAX - size)))
+    {
+        ret = CY_P64_INVALID_ARGUMENT;
+    }
+    else
+    {
+        (void)memset(slot, 0, sizeof(*slot));
+        slot->address = address;
+        slot->size = size;
+
+        cy_p64_mcuboot_parse_header(slot);
+
+        magic = cy_p64_flash_ptr(address + size - CY_P64_MCUBOOT_MAGIC_OFFS);
+        if(memcmp(magic, cy_p64_mcuboot_magic, CY_P64_MCUBOOT_MAGIC_SIZE) == 0)
+        {
+            slot->magic = CY_P64_MCUBOOT_MAGIC_GOOD;
+        }
+        else
+        {
+            for(i = 0u; i < CY_P64_MCUBOOT_MAGIC_SIZE; i++)
+            {
+                erased = erased && (magic[i] == CY_P64_MCUBOOT_ERASED_VAL);
+            }
+            slot->magic = erased ? CY_P64_MCUBOOT_MAGIC_UNSET : CY_P64_MCUBOOT_MAGIC_BAD;
+        }
+
+        slot->image_ok = *cy_p64_flash_ptr(address + size - CY_P64_MCUBOOT_IMAGE_OK_OFFS);
+        slot->copy_done = *cy_p64_flash_ptr(address + size - CY_P64_MCUBOOT_COPY_DONE_OFFS);
+        slot->swap_info = *cy_p64_flash_ptr(address + size - CY_P64_MCUBOOT_SWAP_INFO_OFFS);
+    }
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_mcuboot_tlv_find
+****************************************************************************//**
+* Looks for the TLV entry of the given type in the protected and in the
+* unprotected TLV areas of the image.
+*
+* \param[in] slot           The slot summary from cy_p64_mcuboot_slot_info().
+* \param[in] type           The TLV type, e.g. \ref CY_P64_MCUBOOT_TLV_SHA256.
+* \param[out] address       The flash address of the entry value.
+* \param[out] length        The length of the entry value.
+* \return     \ref CY_P64_SUCCESS for success,
+*             \ref CY_P64_INVALID if the entry is not found or
+*             \ref CY_P64_INVALID_ARGUMENT if the slot has no valid image.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_mcuboot_tlv_find(const cy_p64_mcuboot_slot_t *slot,
+                                             uint8_t type,
+                                             uint32_t *address,
+                                             uint32_t *length)
+{
+    cy_p64_error_codes_t ret = CY_P64_INVALID;
+    uint32_t start;
+    bool found = false;
+
+    if((address == NULL) || (length == NULL))
+    {
+        ret = CY_P64_INVALID_OUT_PAR;
+    }
+    else if((slot == NULL) || (!slot->header_valid))
+    {
+        ret = CY_P64_INVALID_ARGUMENT;
+    }
+    else
+    {
+        if(slot->prot_tlv_size != 0u)
+        {
+            start = slot->address + slot->hdr_size + slot->img_size;
+            found = cy_p64_mcuboot_tlv_search(start + CY_P64_MCUBOOT_TLV_INFO_SIZE,
+                                              start + slot->prot_tlv_size,
+                                              type, address, length);
+        }
+        if(!found)
+        {
+            start = slot->address + slot->tlv_offset;
+            found = cy_p64_mcuboot_tlv_search(start + CY_P64_MCUBOOT_TLV_INFO_SIZE,
+                                              start + slot->tlv_size,
+                                              type, address, length);
+        }
+        if(found)
+        {
+            ret = CY_P64_SUCCESS;
+        }
+    }
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_mcuboot_scan_policy
+****************************************************************************//**
+* Returns the summary of all "BOOT" and "UPGRADE" slots listed in the
+* "boot_upgrade/firmware" array of the provisioning policy, in the policy
+* order. The slots must be in the memory mapped flash.
+*
+* \param[in] json           The JSON object with the policy.
+* \param[out] slots         The array for the slot summaries.
+* \param[in] max_slots      The number of elements in \p slots.
+* \param[out] count         The number of the returned summaries.
+* \return     \ref CY_P64_SUCCESS for success,
+*             \ref CY_P64_INVALID_OUT_PAR if \p slots is too small, the first
+*             \p max_slots summaries are returned or other error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_mcuboot_scan_policy(const cy_p64_cJSON *json,
+                                                cy_p64_mcuboot_slot_t *slots,
+                                                uint32_t max_slots,
+                                                uint32_t *count)
+{
+    cy_p64_error_codes_t ret = CY_P64_SUCCESS;
+    const cy_p64_cJSON *node;
+    const cy_p64_cJSON *json_image;
+    const cy_p64_cJSON *resources;
+    const cy_p64_cJSON *json_res;
+    const cy_p64_cJSON *item;
+    const char *type;
+    uint32_t image_id;
+    uint32_t address;
+    uint32_t size;
+    uint32_t images;
+    uint32_t res_count;
+    uint32_t i;
+    uint32_t j;
+    bool upgrade;
+
+    node = cy_p64_find_json_item("boot_upgrade/firmware", json);
+
+    if((slots == NULL) || (count == NULL))
+    {
+        ret = CY_P64_INVALID_OUT_PAR;
+    }
+    else if(node == NULL)
+    {
+        ret = CY_P64_JWT_ERR_JSN_NONOBJ;
+    }
+    else if(node->type != CY_P64_cJSON_Array)
+    {
+        ret = CY_P64_JWT_ERR_JSN_WRONG_TYPE;
+    }
+    else
+    {
+        *count = 0u;
+        images = (uint32_t)cy_p64_cJSON_GetArraySize(node);
+
+        for(i = 0u; (i < images) && (ret == CY_P64_SUCCESS); i++)
+        {
+            json_image = cy_p64_cJSON_GetArrayItem(node, (int)i);
+            ret = cy_p64_mcuboot_get_uint32(json_image, "id", &image_id);
+            resources = cy_p64_mcuboot_get_item(json_image, "resources");
+            if((ret == CY_P64_SUCCESS) && ((resources == NULL) || (resources->type != CY_P64_cJSON_Array)))
+            {
+                ret = CY_P64_JWT_ERR_JSN_WRONG_TYPE;
+            }
+
+            res_count = (ret == CY_P64_SUCCESS) ? (uint32_t)cy_p64_cJSON_GetArraySize(resources) : 0u;
+            for(j = 0u; (j < res_count) && (ret == CY_P64_SUCCESS); j++)
+            {
+                json_res = cy_p64_cJSON_GetArrayItem(resources, (int)j);
+                item = cy_p64_mcuboot_get_item(json_res, "type");
+                if((item != NULL) && (cy_p64_json_get_string(item, &type) == CY_P64_SUCCESS))
+                {
+                    upgrade = (strcmp(type, "UPGRADE") == 0);
+                    if(upgrade || (strcmp(type, "BOOT") == 0))
+                    {
+                        ret = cy_p64_mcuboot_get_uint32(json_res, "address", &address);
+                        if(ret == CY_P64_SUCCESS)
+                        {
+                            ret = cy_p64_mcuboot_get_uint32(json_res, "size", &size);
+                        }
+                        if((ret == CY_P64_SUCCESS) && (*count >= max_slots))
+                        {
+                            ret = CY_P64_INVALID_OUT_PAR;
+                        }
+                        if(ret == CY_P64_SUCCESS)
+                        {
+                            ret = cy_p64_mcuboot_slot_info(address, size, &slots[*count]);
+                        }
+                        if(ret == CY_P64_SUCCESS)
+                        {
+                            slots[*count].image_id = image_id;
+                            slots[*count].upgrade = upgrade;
+                            (*count)++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
+/** \} */
@@ -0,0 +1,117 @@
+/***************************************************************************//**
+* \file cy_p64_mcuboot.h
+* \version 1.0
+*
+* \brief
+* This is the header file for the MCUboot image header and trailer parser.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef CY_P64_MCUBOOT_H
+#define CY_P64_MCUBOOT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_p64_syscall.h"
+#include "cy_p64_cJSON.h"
+
+/** \addtogroup mcuboot_macros
+ * \{
+ */
+
+/** The image header magic */
+#define CY_P64_MCUBOOT_IMAGE_MAGIC          (0x96f3b83du)
+/** The size of the image header structure */
+#define CY_P64_MCUBOOT_HEADER_SIZE          (32u)
+/** The magic of the unprotected TLV area */
+#define CY_P64_MCUBOOT_TLV_INFO_MAGIC       (0x6907u)
+/** The magic of the protected TLV area */
+#define CY_P64_MCUBOOT_TLV_PROT_INFO_MAGIC  (0x6908u)
+
+/** TLV type: SHA-256 of the image header and payload */
+#define CY_P64_MCUBOOT_TLV_SHA256           (0x10u)
+/** TLV type: ECDSA P-256 signature of the image hash */
+#define CY_P64_MCUBOOT_TLV_ECDSA256         (0x22u)
+
+/** The value of the erased flash: 0x00 for the PSoC 6 internal flash.
+ * Redefine to 0xFF for the slots in the external memory. */
+#ifndef CY_P64_MCUBOOT_ERASED_VAL
+#define CY_P64_MCUBOOT_ERASED_VAL           (0x00u)
+#endif /* CY_P64_MCUBOOT_ERASED_VAL */
+
+/** The trailer flag (image_ok, copy_done) is set */
+#define CY_P64_MCUBOOT_FLAG_SET             (0x01u)
+/** The trailer flag or the swap_info is not written */
+#define CY_P64_MCUBOOT_FLAG_UNSET           (CY_P64_MCUBOOT_ERASED_VAL)
+
+/** \} */
+
+/** \addtogroup mcuboot_t
+ * \{
+ */
+
+/** The state of the trailer magic */
+typedef enum
+{
+    /** The magic is erased: the swap is not requested */
+    CY_P64_MCUBOOT_MAGIC_UNSET = 0,
+    /** The magic is valid: the swap is requested */
+    CY_P64_MCUBOOT_MAGIC_GOOD = 1,
+    /** The magic area contains other data */
+    CY_P64_MCUBOOT_MAGIC_BAD = 2
+} cy_p64_mcuboot_magic_t;
+
+/** The image version from the image header */
+typedef struct
+{
+    uint8_t major;                  /**< The major version */
+    uint8_t minor;                  /**< The minor version */
+    uint16_t revision;              /**< The revision */
+    uint32_t build_num;             /**< The build number */
+} cy_p64_mcuboot_version_t;
+
+/** The summary of the slot header and trailer */
+typedef struct
+{
+    uint32_t image_id;              /**< The image ID from the policy, 0 if unknown */
+    bool upgrade;                   /**< "true" for the upgrade slot */
+    uint32_t address;               /**< The start address of the slot */
+    uint32_t size;                  /**< The size of the slot */
+
+    bool header_valid;              /**< The header magic and sizes are valid */
+    uint32_t load_addr;             /**< The image load address */
+    uint32_t hdr_size;              /**< The size of the header, the payload starts after it */
+    uint32_t img_size;              /**< The size of the payload */
+    uint32_t flags;                 /**< The image flags */
+    cy_p64_mcuboot_version_t version; /**< The image version */
+    uint32_t prot_tlv_size;         /**< The size of the protected TLV area, 0 if absent */
+    uint32_t tlv_offset;            /**< The slot offset of the unprotected TLV area info */
+    uint32_t tlv_size;              /**< The size of the unprotected TLV area including its info */
+
+    cy_p64_mcuboot_magic_t magic;   /**< The state of the trailer magic */
+    uint8_t swap_info;              /**< The raw swap_info byte, \ref CY_P64_MCUBOOT_FLAG_UNSET if not written */
+    uint8_t copy_done;              /**< The raw copy_done byte */
+    uint8_t image_ok;               /**< The raw image_ok byte */
+} cy_p64_mcuboot_slot_t;
+
+/** \} */
+
+/* Public APIs */
+cy_p64_error_codes_t cy_p64_mcuboot_slot_info(uint32_t address, uint32_t size, cy_p64_mcuboot_slot_t *slot);
+cy_p64_error_codes_t cy_p64_mcuboot_tlv_find(const cy_p64_mcuboot_slot_t *slot,
+                                             uint8_t type,
+                                             uint32_t *address,
+                                             uint32_t *length);
+cy_p64_error_codes_t cy_p64_mcuboot_scan_policy(const cy_p64_cJSON *json,
+                                                cy_p64_mcuboot_slot_t *slots,
+                                                uint32_t max_slots,
+                                                uint32_t *count);
+
+#endif /* CY_P64_MCUBOOT_H */
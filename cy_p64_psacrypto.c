@@ -19,6 +19,7 @@
 #include "cy_device.h"
 #include "cy_p64_psacrypto.h"
 #include "cy_p64_syscall.h"
+#include "cy_p64_keycache.h"
 
 /** PSA crypto function code */
 #define CY_P64_PSA_ASYMMETRIC_VERIFY             (0U)
@@ -1591,6 +1592,12 @@ cy_p64_psa_status_t cy_p64_keys_store_key(cy_p64_key_slot_t key_id, cy_p64_psa_k
 
     status = cy_p64_syscall(syscall_cmd);
 
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        /* The slot content is changed, so the cached handle and public key are stale */
+        cy_p64_keycache_invalidate(key_id);
+    }
+
     return status;
 }
 
@@ -1655,6 +1662,12 @@ cy_p64_psa_status_t cy_p64_keys_close_key(cy_p64_key_slot_t key_id)
 
     status = cy_p64_syscall(syscall_cmd);
 
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        /* The slot content is changed, so the cached handle and public key are stale */
+        cy_p64_keycache_invalidate(key_id);
+    }
+
     return status;
 }
 
@@ -1938,70 +1951,344 @@ cy_p64_psa_status_t cy_p64_psa_mac_verify_finish(
     return status;
 }
 
-#ifdef CY_DEVICE_PSOC6ABLE2
+#define CY_P64_MEM_WORD_MASK        (sizeof(uint32_t) - 1u)
+
 /*******************************************************************************
-* Function Name: cy_p64_is_aligned
+* Function Name: cy_p64_mem_is_local
 ****************************************************************************//**
-* Checks if the address is aligned to a given number.
-* The number must be a power of 2 value.
-* \param address   The address to be verified.
-* \param alignment The alignment value
+* Checks if the memory area lies in the normal RAM window, defined by
+* \ref CY_P64_PSA_MEM_LOCAL_START and \ref CY_P64_PSA_MEM_LOCAL_SIZE,
+* which is accessed directly without the syscall. The window is empty by
+* default.
+* \param address   The start address of the area.
+* \param size      The size of the area in bytes.
 * \returns
-* * True, if the 'address' is aligned to the 'alignment' value.
+* * True, if the whole area is in the window.
 * * False, otherwise.
 *******************************************************************************/
-static bool cy_p64_is_aligned(uint32_t address, uint32_t alignment)
+static bool cy_p64_mem_is_local(uint32_t address, size_t size)
 {
     bool ret = false;
 
-    if (alignment > 0u)
+    if(((size_t)CY_P64_PSA_MEM_LOCAL_SIZE != 0u) &&
+       (address >= (uint32_t)CY_P64_PSA_MEM_LOCAL_START) &&
+       (size <= (size_t)CY_P64_PSA_MEM_LOCAL_SIZE))
     {
-        if ((address & (alignment - 1u)) == 0u)
+        if((address - (uint32_t)CY_P64_PSA_MEM_LOCAL_START) <= ((uint32_t)CY_P64_PSA_MEM_LOCAL_SIZE - size))
         {
             ret = true;
         }
     }
     return (ret);
 }
+
+/*******************************************************************************
+* Function Name: cy_p64_mem_copy_local
+****************************************************************************//**
+* Copies the memory by words when both areas have the same alignment offset,
+* the head and tail bytes and the other cases are copied by bytes.
+*******************************************************************************/
+static void cy_p64_mem_copy_local(uint8_t *dst, const uint8_t *src, size_t size)
+{
+    size_t i = 0u;
+
+    if((((uint32_t)dst ^ (uint32_t)src) & CY_P64_MEM_WORD_MASK) == 0u)
+    {
+        while((i < size) && (((uint32_t)&dst[i] & CY_P64_MEM_WORD_MASK) != 0u))
+        {
+            dst[i] = src[i];
+            i++;
+        }
+        while((size - i) >= sizeof(uint32_t))
+        {
+            *(uint32_t *)&dst[i] = *(const uint32_t *)&src[i];
+            i += sizeof(uint32_t);
+        }
+    }
+    while(i < size)
+    {
+        dst[i] = src[i];
+        i++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: cy_p64_mem_set_local
+****************************************************************************//**
+* Fills the memory by words, the unaligned head and tail are filled by bytes.
+*******************************************************************************/
+static void cy_p64_mem_set_local(uint8_t *dst, uint8_t val, size_t size)
+{
+    uint32_t word = (uint32_t)val * 0x01010101u;
+    size_t i = 0u;
+
+    while((i < size) && (((uint32_t)&dst[i] & CY_P64_MEM_WORD_MASK) != 0u))
+    {
+        dst[i] = val;
+        i++;
+    }
+    while((size - i) >= sizeof(uint32_t))
+    {
+        *(uint32_t *)&dst[i] = word;
+        i += sizeof(uint32_t);
+    }
+    while(i < size)
+    {
+        dst[i] = val;
+        i++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: cy_p64_mem_set_syscall
+****************************************************************************//**
+* Fills the memory with the Secure FlashBoot MEMSET syscall.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_mem_set_syscall(void *dst_addr, uint8_t val, size_t data_size)
+{
+    cy_p64_psa_status_t status = CY_P64_PSA_ERROR_NOT_SUPPORTED;
+
+    uint32_t syscall_cmd[2];
+    uint32_t syscall_param[3];
+
+    syscall_cmd[0] = CY_P64_SYSCALL_PSA_CRYPTO_CMD(CY_P64_PSA_MEMSET);
+    syscall_cmd[1] = (uint32_t)syscall_param;
+
+    syscall_param[0] = (uint32_t)dst_addr;
+    syscall_param[1] = (uint32_t)val;
+    syscall_param[2] = (uint32_t)data_size;
+
+    status = cy_p64_syscall(syscall_cmd);
+
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: cy_p64_mem_copy_syscall
+****************************************************************************//**
+* Copies the memory with the Secure FlashBoot MEMCPY syscall.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_mem_copy_syscall(void *dst_addr, void const *src_addr, size_t data_size)
+{
+    cy_p64_psa_status_t status = CY_P64_PSA_ERROR_NOT_SUPPORTED;
+
+    uint32_t syscall_cmd[2];
+    uint32_t syscall_param[3];
+
+    syscall_cmd[0] = CY_P64_SYSCALL_PSA_CRYPTO_CMD(CY_P64_PSA_MEMCPY);
+    syscall_cmd[1] = (uint32_t)syscall_param;
+
+    syscall_param[0] = (uint32_t)dst_addr;
+    syscall_param[1] = (uint32_t)src_addr;
+    syscall_param[2] = (uint32_t)data_size;
+
+    status = cy_p64_syscall(syscall_cmd);
+
+    return status;
+}
+
+#ifdef CY_DEVICE_PSOC6ABLE2
+/* The size of the aligned buffer used to copy between a local area and
+ * a protected area that have different alignment offsets */
+#define CY_P64_MEM_BOUNCE_SIZE      (32u)
+
+/*******************************************************************************
+* Function Name: cy_p64_mem_read_bytes
+****************************************************************************//**
+* Reads up to 4 bytes into the local buffer. A protected source must not cross
+* the word boundary, the word containing it is read with the syscall.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_mem_read_bytes(uint8_t *dst, const uint8_t *src, size_t size)
+{
+    cy_p64_psa_status_t status = CY_P64_PSA_SUCCESS;
+    uint32_t word = 0u;
+
+    if(cy_p64_mem_is_local((uint32_t)src, size))
+    {
+        cy_p64_mem_copy_local(dst, src, size);
+    }
+    else
+    {
+        status = cy_p64_mem_copy_syscall(&word, (void const *)((uint32_t)src & ~CY_P64_MEM_WORD_MASK),
+                                         sizeof(word));
+        if(status == CY_P64_PSA_SUCCESS)
+        {
+            cy_p64_mem_copy_local(dst, &((uint8_t *)&word)[(uint32_t)src & CY_P64_MEM_WORD_MASK], size);
+        }
+    }
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: cy_p64_mem_write_bytes
+****************************************************************************//**
+* Writes up to 4 bytes from the local buffer. A protected destination must not
+* cross the word boundary, the word containing it is read, modified and
+* written back with the syscall.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_mem_write_bytes(uint8_t *dst, const uint8_t *src, size_t size)
+{
+    cy_p64_psa_status_t status = CY_P64_PSA_SUCCESS;
+    void *aligned = (void *)((uint32_t)dst & ~CY_P64_MEM_WORD_MASK);
+    uint32_t word = 0u;
+
+    if(cy_p64_mem_is_local((uint32_t)dst, size))
+    {
+        cy_p64_mem_copy_local(dst, src, size);
+    }
+    else
+    {
+        status = cy_p64_mem_copy_syscall(&word, aligned, sizeof(word));
+        if(status == CY_P64_PSA_SUCCESS)
+        {
+            cy_p64_mem_copy_local(&((uint8_t *)&word)[(uint32_t)dst & CY_P64_MEM_WORD_MASK], src, size);
+            status = cy_p64_mem_copy_syscall(aligned, &word, sizeof(word));
+        }
+    }
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: cy_p64_mem_copy_split
+****************************************************************************//**
+* Copies the memory when at least one area is protected. The syscall accepts
+* only word aligned addresses, so the unaligned head and tail are copied
+* by bytes around the aligned middle part. The areas with different alignment
+* offsets are copied through an aligned local buffer when one of them is local,
+* otherwise they are copied word by word.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_mem_copy_split(uint8_t *dst, const uint8_t *src, size_t size)
+{
+    cy_p64_psa_status_t status = CY_P64_PSA_SUCCESS;
+    bool dst_local = cy_p64_mem_is_local((uint32_t)dst, size);
+    bool src_local = cy_p64_mem_is_local((uint32_t)src, size);
+    uint32_t bounce[CY_P64_MEM_BOUNCE_SIZE / sizeof(uint32_t)];
+    uint32_t dst_off;
+    uint32_t src_off;
+    size_t len;
+
+    while((size > 0u) && (status == CY_P64_PSA_SUCCESS))
+    {
+        dst_off = (uint32_t)dst & CY_P64_MEM_WORD_MASK;
+        src_off = (uint32_t)src & CY_P64_MEM_WORD_MASK;
+        len = size & ~(size_t)CY_P64_MEM_WORD_MASK;
+
+        if((len > 0u) && (dst_off == 0u) && (src_off == 0u))
+        {
+            status = cy_p64_mem_copy_syscall(dst, src, len);
+        }
+        else if((len > 0u) && (dst_off == 0u) && src_local)
+        {
+            len = (len < sizeof(bounce)) ? len : sizeof(bounce);
+            cy_p64_mem_copy_local((uint8_t *)bounce, src, len);
+            status = cy_p64_mem_copy_syscall(dst, bounce, len);
+        }
+        else if((len > 0u) && (src_off == 0u) && dst_local)
+        {
+            len = (len < sizeof(bounce)) ? len : sizeof(bounce);
+            status = cy_p64_mem_copy_syscall(bounce, src, len);
+            if(status == CY_P64_PSA_SUCCESS)
+            {
+                cy_p64_mem_copy_local(dst, (const uint8_t *)bounce, len);
+            }
+        }
+        else
+        {
+            len = sizeof(uint32_t);
+            if(!dst_local)
+            {
+                len -= dst_off;
+            }
+            if((!src_local) && ((sizeof(uint32_t) - src_off) < len))
+            {
+                len = sizeof(uint32_t) - src_off;
+            }
+            len = (len < size) ? len : size;
+
+            status = cy_p64_mem_read_bytes((uint8_t *)bounce, src, len);
+            if(status == CY_P64_PSA_SUCCESS)
+            {
+                status = cy_p64_mem_write_bytes(dst, (const uint8_t *)bounce, len);
+            }
+        }
+
+        dst += len;
+        src += len;
+        size -= len;
+    }
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: cy_p64_mem_set_split
+****************************************************************************//**
+* Fills the protected memory. The syscall accepts only word aligned addresses,
+* so the unaligned head and tail are written by bytes around the aligned
+* middle part.
+*******************************************************************************/
+static cy_p64_psa_status_t cy_p64_mem_set_split(uint8_t *dst, uint8_t val, size_t size)
+{
+    cy_p64_psa_status_t status = CY_P64_PSA_SUCCESS;
+    uint32_t word = (uint32_t)val * 0x01010101u;
+    uint32_t dst_off;
+    size_t len;
+
+    while((size > 0u) && (status == CY_P64_PSA_SUCCESS))
+    {
+        dst_off = (uint32_t)dst & CY_P64_MEM_WORD_MASK;
+        len = size & ~(size_t)CY_P64_MEM_WORD_MASK;
+
+        if((len > 0u) && (dst_off == 0u))
+        {
+            status = cy_p64_mem_set_syscall(dst, val, len);
+        }
+        else
+        {
+            len = sizeof(uint32_t) - dst_off;
+            len = (len < size) ? len : size;
+            status = cy_p64_mem_write_bytes(dst, (const uint8_t *)&word, len);
+        }
+
+        dst += len;
+        size -= len;
+    }
+    return status;
+}
 #endif /* CY_DEVICE_PSOC6ABLE2 */
 
 /**
  * This function fills the first \p data_size bytes of the array
  * pointed to by \p dst_addr to the value \p val.
  *
- * \param[in]  dst_addr    Destination memory area, must be aligned to 4
- *                         bytes for CY_DEVICE_PSOC6ABLE2 device
+ * The memory in the normal RAM window (\ref CY_P64_PSA_MEM_LOCAL_START,
+ * \ref CY_P64_PSA_MEM_LOCAL_SIZE) is filled directly, other memory
+ * is filled with the Secure FlashBoot syscall. For CY_DEVICE_PSOC6ABLE2
+ * device the unaligned head and tail of the protected memory are written
+ * by read-modify-write of the containing words.
+ *
+ * \param[in]  dst_addr    Destination memory area
  * \param[in]  val         The value
  * \param[in]  data_size   The size of the data buffer in bytes.
  *
- * \return           Pointer to the destination memory block or NULL on error
+ * \return           #CY_P64_PSA_SUCCESS or the syscall error code
  */
 cy_p64_psa_status_t cy_p64_psa_memset(void *dst_addr, uint8_t val, size_t data_size)
 {
     cy_p64_psa_status_t status = CY_P64_PSA_ERROR_NOT_SUPPORTED;
 
-    uint32_t syscall_cmd[2];
-    uint32_t syscall_param[3];
-
-#ifdef CY_DEVICE_PSOC6ABLE2
-    if(cy_p64_is_aligned((uint32_t)dst_addr, sizeof(uint32_t)))
-#endif /* CY_DEVICE_PSOC6ABLE2 */
+    if(cy_p64_mem_is_local((uint32_t)dst_addr, data_size))
     {
-        syscall_cmd[0] = CY_P64_SYSCALL_PSA_CRYPTO_CMD(CY_P64_PSA_MEMSET);
-        syscall_cmd[1] = (uint32_t)syscall_param;
-
-        syscall_param[0] = (uint32_t)dst_addr;
-        syscall_param[1] = (uint32_t)val;
-        syscall_param[2] = (uint32_t)data_size;
-
-        status = cy_p64_syscall(syscall_cmd);
+        cy_p64_mem_set_local((uint8_t *)dst_addr, val, data_size);
+        status = CY_P64_PSA_SUCCESS;
     }
-#ifdef CY_DEVICE_PSOC6ABLE2
     else
     {
-        status = CY_P64_PSA_ERROR_INVALID_ARGUMENT;
-    }
+#ifdef CY_DEVICE_PSOC6ABLE2
+        status = cy_p64_mem_set_split((uint8_t *)dst_addr, val, data_size);
+#else
+        status = cy_p64_mem_set_syscall(dst_addr, val, data_size);
 #endif /* CY_DEVICE_PSOC6ABLE2 */
+    }
 
     return status;
 }
@@ -2010,43 +2297,36 @@ cy_p64_psa_status_t cy_p64_psa_memset(void *dst_addr, uint8_t val, size_t data_s
  * This function copies the \p data_size bytes from the memory area pointed
  * by \p src_addr in to the memory area pointed by \p dst_addr.
  *
- * Returns a pointer to the first byte of the out area.
+ * The areas in the normal RAM window (\ref CY_P64_PSA_MEM_LOCAL_START,
+ * \ref CY_P64_PSA_MEM_LOCAL_SIZE) are copied directly, otherwise the memory
+ * is copied with the Secure FlashBoot syscall. For CY_DEVICE_PSOC6ABLE2
+ * device the unaligned parts are copied around the aligned middle part.
+ * The areas must not overlap.
  *
- * \param[in]  dst_addr    Destination memory area, must be aligned to 4
- *                         bytes for CY_DEVICE_PSOC6ABLE2 device
- * \param[in]  src_addr    Source memory area, must be aligned to 4
- *                         bytes for CY_DEVICE_PSOC6ABLE2 device
+ * \param[in]  dst_addr    Destination memory area
+ * \param[in]  src_addr    Source memory area
  * \param[in]  data_size   The size of the data buffer in bytes.
  *
- * \return           The pointer to the destination memory block or NULL on error.
+ * \return           #CY_P64_PSA_SUCCESS or the syscall error code
  */
 cy_p64_psa_status_t cy_p64_psa_memcpy(void *dst_addr, void const *src_addr, size_t data_size)
 {
     cy_p64_psa_status_t status = CY_P64_PSA_ERROR_NOT_SUPPORTED;
 
-    uint32_t syscall_cmd[2];
-    uint32_t syscall_param[3];
-
-#ifdef CY_DEVICE_PSOC6ABLE2
-    if(cy_p64_is_aligned((uint32_t)dst_addr, sizeof(uint32_t)) &&
-       cy_p64_is_aligned((uint32_t)src_addr, sizeof(uint32_t)))
-#endif /* CY_DEVICE_PSOC6ABLE2 */
+    if(cy_p64_mem_is_local((uint32_t)dst_addr, data_size) &&
+       cy_p64_mem_is_local((uint32_t)src_addr, data_size))
     {
-        syscall_cmd[0] = CY_P64_SYSCALL_PSA_CRYPTO_CMD(CY_P64_PSA_MEMCPY);
-        syscall_cmd[1] = (uint32_t)syscall_param;
-
-        syscall_param[0] = (uint32_t)dst_addr;
-        syscall_param[1] = (uint32_t)src_addr;
-        syscall_param[2] = (uint32_t)data_size;
-
-        status = cy_p64_syscall(syscall_cmd);
+        cy_p64_mem_copy_local((uint8_t *)dst_addr, (const uint8_t *)src_addr, data_size);
+        status = CY_P64_PSA_SUCCESS;
     }
-#ifdef CY_DEVICE_PSOC6ABLE2
     else
     {
-        status = CY_P64_PSA_ERROR_INVALID_ARGUMENT;
-    }
+#ifdef CY_DEVICE_PSOC6ABLE2
+        status = cy_p64_mem_copy_split((uint8_t *)dst_addr, (const uint8_t *)src_addr, data_size);
+#else
+        status = cy_p64_mem_copy_syscall(dst_addr, src_addr, data_size);
 #endif /* CY_DEVICE_PSOC6ABLE2 */
+    }
 
     return status;
 }
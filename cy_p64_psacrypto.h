@@ -287,6 +287,23 @@ cy_p64_psa_status_t cy_p64_psa_mac_verify_finish(
 /** \addtogroup mem
  * \{
  */
+
+/** The start address of the normal RAM window. cy_p64_psa_memset() and
+ * cy_p64_psa_memcpy() access the memory inside the window directly, without
+ * the syscall. The window must not include the RAM protected from the
+ * current core (SFB and CM0+ SRAM), otherwise the direct access faults. */
+#ifndef CY_P64_PSA_MEM_LOCAL_START
+#define CY_P64_PSA_MEM_LOCAL_START          (CY_SRAM_BASE)
+#endif /* CY_P64_PSA_MEM_LOCAL_START */
+
+/** The size of the normal RAM window in bytes. The default 0 routes all
+ * operations through the syscall. Define it together with
+ * \ref CY_P64_PSA_MEM_LOCAL_START to opt in to the direct access, e.g. with
+ * the non-secure RAM region of the application linker script. */
+#ifndef CY_P64_PSA_MEM_LOCAL_SIZE
+#define CY_P64_PSA_MEM_LOCAL_SIZE           (0u)
+#endif /* CY_P64_PSA_MEM_LOCAL_SIZE */
+
 cy_p64_psa_status_t cy_p64_psa_memset(
     void *dst_addr,
     uint8_t val,
@@ -66,9 +66,9 @@
  */
 #define CY_P64_PSA_HASH_SIZE(alg)                                      \
     (                                                           \
-        CY_P64_ALG_HMAC_GET_HASH(alg) == CY_P64_ALG_SHA_224 ? 28 :        \
-        CY_P64_ALG_HMAC_GET_HASH(alg) == CY_P64_ALG_SHA_256 ? 32 :        \
-        0)
+        CY_P64_PSA_ALG_HMAC_GET_HASH(alg) == CY_P64_PSA_ALG_SHA_224 ? 28u : \
+        CY_P64_PSA_ALG_HMAC_GET_HASH(alg) == CY_P64_PSA_ALG_SHA_256 ? 32u : \
+        0u)
 
 /** \def CY_P64_PSA_HASH_MAX_SIZE
  *
@@ -0,0 +1,190 @@
+/***************************************************************************//**
+* \file cy_p64_random.c
+* \version 1.0
+*
+* \brief
+* This is the source code file for the buffered random number generation
+* functions.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+/*******************************************************************************
+* Random pool Prototypes
+****************************************************************************//**
+*
+* \defgroup random_pool     Random pool
+*
+* \brief
+*  This library buffers the output of cy_p64_psa_generate_random(), so short
+*  random numbers (nonces, IVs) are served from RAM instead of a syscall.
+*  The pool of \ref CY_P64_RANDOM_POOL_SIZE bytes is refilled with one syscall
+*  and each consumed byte is cleared in the pool.
+*
+*  The functions are not re-entrant. When the pool is used from several
+*  threads, the caller must serialize the calls, including
+*  cy_p64_random_idle_hook().
+*
+* \{
+*   \defgroup random_pool_api Functions
+*   \defgroup random_pool_macros Macros
+* \}
+*******************************************************************************/
+
+#include <string.h>
+#include "cy_p64_random.h"
+
+
+static uint32_t cy_p64_random_pool[CY_P64_RANDOM_POOL_SIZE / sizeof(uint32_t)];
+/* The number of unused bytes, they are stored at the end of the pool */
+static size_t cy_p64_random_avail = 0u;
+
+
+/*******************************************************************************
+* Function Name: cy_p64_random_zeroize
+****************************************************************************//**
+* Clears the buffer, the volatile access prevents the compiler from removing
+* the clearing of the data which is not read after.
+*
+* \param[in] buf        The buffer to clear.
+* \param[in] size       The size of the buffer in bytes.
+*******************************************************************************/
+static void cy_p64_random_zeroize(uint8_t *buf, size_t size)
+{
+    volatile uint8_t *p = buf;
+    size_t i;
+
+    for(i = 0u; i < size; i++)
+    {
+        p[i] = 0u;
+    }
+}
+
+
+/*******************************************************************************
+* Function Prototypes
+****************************************************************************//**
+*
+*  \addtogroup random_pool_api
+*
+*  \{
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: cy_p64_random_get
+****************************************************************************//**
+* Generates random bytes. The requests up to \ref CY_P64_RANDOM_POOL_SIZE bytes
+* are served from the pool, which is refilled with cy_p64_psa_generate_random()
+* when it is empty. Larger requests call cy_p64_psa_generate_random() directly.
+*
+* \param[out] output        The output buffer for the generated data.
+* \param[in] output_size    The number of bytes to generate.
+*
+* \retval #CY_P64_PSA_SUCCESS
+* \retval #CY_P64_PSA_ERROR_INVALID_ARGUMENT
+* \retval #CY_P64_PSA_ERROR_INSUFFICIENT_ENTROPY
+*******************************************************************************/
+cy_p64_psa_status_t cy_p64_random_get(uint8_t *output, size_t output_size)
+{
+    cy_p64_psa_status_t status = CY_P64_PSA_SUCCESS;
+    uint8_t *pool = (uint8_t *)cy_p64_random_pool;
+    size_t copied = 0u;
+    size_t chunk;
+
+    if((output == NULL) && (output_size != 0u))
+    {
+        status = CY_P64_PSA_ERROR_INVALID_ARGUMENT;
+    }
+    else if(output_size > CY_P64_RANDOM_POOL_SIZE)
+    {
+        status = cy_p64_psa_generate_random(output, output_size);
+    }
+    else
+    {
+        while((status == CY_P64_PSA_SUCCESS) && (copied < output_size))
+        {
+            if(cy_p64_random_avail == 0u)
+            {
+                status = cy_p64_random_refill();
+            }
+            else
+            {
+                chunk = output_size - copied;
+                if(chunk > cy_p64_random_avail)
+                {
+                    chunk = cy_p64_random_avail;
+                }
+
+                cy_p64_random_avail -= chunk;
+                (void)memcpy(&output[copied], &pool[CY_P64_RANDOM_POOL_SIZE - cy_p64_random_avail - chunk], chunk);
+                cy_p64_random_zeroize(&pool[CY_P64_RANDOM_POOL_SIZE - cy_p64_random_avail - chunk], chunk);
+                copied += chunk;
+            }
+        }
+    }
+
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_random_refill
+****************************************************************************//**
+* Fills the whole pool with new random bytes by one cy_p64_psa_generate_random()
+* call. The unused bytes are discarded.
+*
+* \retval #CY_P64_PSA_SUCCESS
+* \retval #CY_P64_PSA_ERROR_INSUFFICIENT_ENTROPY
+*******************************************************************************/
+cy_p64_psa_status_t cy_p64_random_refill(void)
+{
+    cy_p64_psa_status_t status;
+
+    status = cy_p64_psa_generate_random((uint8_t *)cy_p64_random_pool, CY_P64_RANDOM_POOL_SIZE);
+    if(status == CY_P64_PSA_SUCCESS)
+    {
+        cy_p64_random_avail = CY_P64_RANDOM_POOL_SIZE;
+    }
+    else
+    {
+        cy_p64_random_flush();
+    }
+
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_random_idle_hook
+****************************************************************************//**
+* Refills the pool when fewer than \ref CY_P64_RANDOM_POOL_REFILL_THRESHOLD bytes
+* are left. Call this function from the idle loop or the RTOS idle hook, so the
+* following cy_p64_random_get() calls do not wait for the syscall.
+*******************************************************************************/
+void cy_p64_random_idle_hook(void)
+{
+    if(cy_p64_random_avail < CY_P64_RANDOM_POOL_REFILL_THRESHOLD)
+    {
+        (void)cy_p64_random_refill();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_random_flush
+****************************************************************************//**
+* Clears the pool and discards all unused random bytes.
+*******************************************************************************/
+void cy_p64_random_flush(void)
+{
+    cy_p64_random_zeroize((uint8_t *)cy_p64_random_pool, sizeof(cy_p64_random_pool));
+    cy_p64_random_avail = 0u;
+}
+
+/** \} */
@@ -0,0 +1,48 @@
+/***************************************************************************//**
+* \file cy_p64_random.h
+* \version 1.0
+*
+* \brief
+* This is the header file for the buffered random number generation functions.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef CY_P64_RANDOM_H
+#define CY_P64_RANDOM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "cy_p64_psacrypto.h"
+
+/** \addtogroup random_pool_macros
+ * \{
+ */
+
+/** The size in bytes of the random pool refilled by one
+ * cy_p64_psa_generate_random() call. Must be a multiple of 4. */
+#ifndef CY_P64_RANDOM_POOL_SIZE
+#define CY_P64_RANDOM_POOL_SIZE             (128u)
+#endif /* CY_P64_RANDOM_POOL_SIZE */
+
+/** cy_p64_random_idle_hook() refills the pool when fewer bytes than this
+ * value are left in it. */
+#ifndef CY_P64_RANDOM_POOL_REFILL_THRESHOLD
+#define CY_P64_RANDOM_POOL_REFILL_THRESHOLD (CY_P64_RANDOM_POOL_SIZE / 2u)
+#endif /* CY_P64_RANDOM_POOL_REFILL_THRESHOLD */
+
+/** \} */
+
+/* Public APIs */
+cy_p64_psa_status_t cy_p64_random_get(uint8_t *output, size_t output_size);
+cy_p64_psa_status_t cy_p64_random_refill(void);
+void cy_p64_random_idle_hook(void);
+void cy_p64_random_flush(void);
+
+#endif /* CY_P64_RANDOM_H */
@@ -0,0 +1,244 @@
+/***************************************************************************//**
+* \file cy_p64_rollback.c
+* \version 1.0
+*
+* \brief
+* This is the source code file for the rollback counter shadow table functions.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+/*******************************************************************************
+* Rollback counter shadow Prototypes
+****************************************************************************//**
+*
+* \defgroup rollback     Rollback counter shadow
+*
+* \brief
+*  This library keeps a RAM copy of the Secure FlashBoot rollback counters.
+*  Each counter is read with the syscall only once, the following reads are
+*  answered from RAM.
+*
+*  The updates are collected by cy_p64_rollback_shadow_set() and written by
+*  cy_p64_rollback_shadow_commit() in one sequence. The counters can only
+*  grow: a lower value is rejected when it is set, several updates of one
+*  counter are coalesced into one write of the highest value and a value
+*  equal to the current one is not written at all.
+*
+*  cy_p64_update_rollback_counter() invalidates the RAM copy of the counter,
+*  so the direct updates are visible through the shadow table.
+*
+*  The functions are not re-entrant.
+*
+* \{
+*   \defgroup rollback_api Functions
+*   \defgroup rollback_macros Macros
+* \}
+*******************************************************************************/
+
+#include "cy_p64_rollback.h"
+#include "cy_p64_syscalls.h"
+
+static uint32_t cy_p64_rollback_shadow[CY_P64_ROLLBACK_COUNTER_COUNT];
+static uint32_t cy_p64_rollback_pending[CY_P64_ROLLBACK_COUNTER_COUNT];
+/* Bit masks of the counters with the valid RAM copy and with the pending update */
+static uint32_t cy_p64_rollback_valid_mask = 0u;
+static uint32_t cy_p64_rollback_pending_mask = 0u;
+
+
+/*******************************************************************************
+* Function Name: cy_p64_rollback_shadow_read
+****************************************************************************//**
+* Reads the counter into the shadow table if it is not there yet.
+*******************************************************************************/
+static cy_p64_error_codes_t cy_p64_rollback_shadow_read(uint32_t number)
+{
+    cy_p64_error_codes_t ret = CY_P64_SUCCESS;
+    uint32_t value = 0u;
+
+    if((cy_p64_rollback_valid_mask & (1UL << number)) == 0u)
+    {
+        ret = cy_p64_get_rollback_counter(number, &value);
+        if(ret == CY_P64_SUCCESS)
+        {
+            cy_p64_rollback_shadow[number] = value;
+            cy_p64_rollback_valid_mask |= (1UL << number);
+        }
+    }
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Prototypes
+****************************************************************************//**
+*
+*  \addtogroup rollback_api
+*
+*  \{
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: cy_p64_rollback_shadow_load
+****************************************************************************//**
+* Reads all rollback counters which are not in the shadow table yet.
+*
+* \return     \ref CY_P64_SUCCESS for success or error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_rollback_shadow_load(void)
+{
+    cy_p64_error_codes_t ret = CY_P64_SUCCESS;
+    uint32_t i;
+
+    for(i = 0u; (i < CY_P64_ROLLBACK_COUNTER_COUNT) && (ret == CY_P64_SUCCESS); i++)
+    {
+        ret = cy_p64_rollback_shadow_read(i);
+    }
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_rollback_shadow_get
+****************************************************************************//**
+* Returns the committed value of the rollback counter. The pending update is
+* not returned until it is committed.
+*
+* \param[in] number     Rollback counter number (0-15).
+* \param[out] value     The counter value.
+* \return     \ref CY_P64_SUCCESS for success or error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_rollback_shadow_get(uint32_t number, uint32_t *value)
+{
+    cy_p64_error_codes_t ret;
+
+    if(value == NULL)
+    {
+        ret = CY_P64_INVALID_OUT_PAR;
+    }
+    else if(number >= CY_P64_ROLLBACK_COUNTER_COUNT)
+    {
+        ret = CY_P64_INVALID_ARGUMENT;
+    }
+    else
+    {
+        ret = cy_p64_rollback_shadow_read(number);
+        if(ret == CY_P64_SUCCESS)
+        {
+            *value = cy_p64_rollback_shadow[number];
+        }
+    }
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_rollback_shadow_set
+****************************************************************************//**
+* Schedules the update of the rollback counter. The value lower than the
+* current or the pending value is rejected, the value equal to the current one
+* is ignored.
+*
+* \param[in] number     Rollback counter number (0-15).
+* \param[in] value      The new value.
+* \return     \ref CY_P64_SUCCESS for success,
+*             \ref CY_P64_INVALID_ARGUMENT if the value is lower than
+*             the current or the pending one or other error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_rollback_shadow_set(uint32_t number, uint32_t value)
+{
+    cy_p64_error_codes_t ret;
+
+    if(number >= CY_P64_ROLLBACK_COUNTER_COUNT)
+    {
+        ret = CY_P64_INVALID_ARGUMENT;
+    }
+    else
+    {
+        ret = cy_p64_rollback_shadow_read(number);
+        if(ret == CY_P64_SUCCESS)
+        {
+            if((value < cy_p64_rollback_shadow[number]) ||
+               (((cy_p64_rollback_pending_mask & (1UL << number)) != 0u) &&
+                (value < cy_p64_rollback_pending[number])))
+            {
+                ret = CY_P64_INVALID_ARGUMENT;
+            }
+            else if(value > cy_p64_rollback_shadow[number])
+            {
+                cy_p64_rollback_pending[number] = value;
+                cy_p64_rollback_pending_mask |= (1UL << number);
+            }
+            else
+            {
+                /* The counter already has this value */
+            }
+        }
+    }
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_rollback_shadow_commit
+****************************************************************************//**
+* Writes all pending updates. The commit stops at the first error, the updates
+* not written yet stay pending.
+*
+* \return     \ref CY_P64_SUCCESS for success or error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_rollback_shadow_commit(void)
+{
+    cy_p64_error_codes_t ret = CY_P64_SUCCESS;
+    uint32_t i;
+
+    for(i = 0u; (i < CY_P64_ROLLBACK_COUNTER_COUNT) && (ret == CY_P64_SUCCESS); i++)
+    {
+        if((cy_p64_rollback_pending_mask & (1UL << i)) != 0u)
+        {
+            ret = cy_p64_update_rollback_counter(i, cy_p64_rollback_pending[i]);
+            if(ret == CY_P64_SUCCESS)
+            {
+                cy_p64_rollback_shadow[i] = cy_p64_rollback_pending[i];
+                cy_p64_rollback_valid_mask |= (1UL << i);
+                cy_p64_rollback_pending_mask &= ~(1UL << i);
+            }
+        }
+    }
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_rollback_shadow_discard
+****************************************************************************//**
+* Drops all pending updates.
+*******************************************************************************/
+void cy_p64_rollback_shadow_discard(void)
+{
+    cy_p64_rollback_pending_mask = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_rollback_shadow_invalidate
+****************************************************************************//**
+* Drops the RAM copy of the counter, it is read again on the next access.
+*
+* \param[in] number     Rollback counter number (0-15).
+*******************************************************************************/
+void cy_p64_rollback_shadow_invalidate(uint32_t number)
+{
+    if(number < CY_P64_ROLLBACK_COUNTER_COUNT)
+    {
+        cy_p64_rollback_valid_mask &= ~(1UL << number);
+    }
+}
+
+/** \} */
@@ -0,0 +1,40 @@
+/***************************************************************************//**
+* \file cy_p64_rollback.h
+* \version 1.0
+*
+* \brief
+* This is the header file for the rollback counter shadow table functions.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef CY_P64_ROLLBACK_H
+#define CY_P64_ROLLBACK_H
+
+#include <stdint.h>
+#include "cy_p64_syscall.h"
+
+/** \addtogroup rollback_macros
+ * \{
+ */
+
+/** The number of the rollback counters in Secure FlashBoot */
+#define CY_P64_ROLLBACK_COUNTER_COUNT       (16u)
+
+/** \} */
+
+/* Public APIs */
+cy_p64_error_codes_t cy_p64_rollback_shadow_load(void);
+cy_p64_error_codes_t cy_p64_rollback_shadow_get(uint32_t number, uint32_t *value);
+cy_p64_error_codes_t cy_p64_rollback_shadow_set(uint32_t number, uint32_t value);
+cy_p64_error_codes_t cy_p64_rollback_shadow_commit(void);
+void cy_p64_rollback_shadow_discard(void);
+void cy_p64_rollback_shadow_invalidate(uint32_t number);
+
+#endif /* CY_P64_ROLLBACK_H */
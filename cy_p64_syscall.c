@@ -34,6 +34,7 @@
 #include "cy_crypto_common.h"
 #include "cy_crypto_core.h"
 #include "cy_p64_syscall.h"
+#include "cy_p64_watchdog.h"
 #include "cy_prot.h"
 #include "cy_device_headers.h"
 
@@ -91,6 +92,33 @@ static bool IsCryptoPpuDisabled(void)
  * \{
  */
 
+/*******************************************************************************
+* Function Name: cy_p64_is_crypto_enabled
+****************************************************************************//**
+*
+* Checks whether the Crypto HW is accessible by the current core and enabled,
+* so the Crypto driver can be used directly without a syscall.
+*
+* \return
+* true if the Crypto HW is accessible and enabled.
+* false otherwise.
+*
+*******************************************************************************/
+bool cy_p64_is_crypto_enabled(void)
+{
+    bool crypto_is_enabled = false;
+
+#if (CY_CPU_CORTEX_M4) /* Check if Crypto is enabled for M4 core access by PPU */
+    if(IsCryptoPpuDisabled())
+#endif /* (CY_CPU_CORTEX_M4) */
+    {
+        crypto_is_enabled = Cy_Crypto_Core_IsEnabled(CRYPTO);
+    }
+
+    return crypto_is_enabled;
+}
+
+
 /*******************************************************************************
 * Function Name: cy_p64_syscall
 ****************************************************************************//**
@@ -111,14 +139,8 @@ cy_p64_error_codes_t cy_p64_syscall(uint32_t *cmd)
     uint32_t timeout = 0U;
     cy_en_ipcdrv_status_t ipc_status = CY_IPC_DRV_ERROR;
     cy_p64_error_codes_t status = CY_P64_INVALID_TIMEOUT;
-    bool crypto_is_enabled = false;
+    bool crypto_is_enabled = cy_p64_is_crypto_enabled();
 
-#if (CY_CPU_CORTEX_M4) /* Check if Crypto is enabled for M4 core access by PPU */
-    if(IsCryptoPpuDisabled())
-#endif /* (CY_CPU_CORTEX_M4) */
-    {
-        crypto_is_enabled = Cy_Crypto_Core_IsEnabled(CRYPTO);
-    }
     if(crypto_is_enabled)
     {
         /* Syscall will disable Crypto HW,
@@ -151,6 +173,7 @@ cy_p64_error_codes_t cy_p64_syscall(uint32_t *cmd)
               (timeout < CY_P64_PSACRYPTO_SYSCALL_TIMEOUT_LONG))
         {
             ++timeout;
+            cy_p64_wdg_heartbeat();
         #if (defined(CY_DEVICE_PSOC6A2M) || defined(CY_DEVICE_PSOC6A512K))
             /* Read PPU#4 registers as a workaround for ID# 338574 */
             (void)CY_GET_REG32(PERI_MS_PPU_PR4);
@@ -60,6 +60,7 @@
 #define CY_P64_SYSCALL_H
 
 #include <stdint.h>
+#include <stdbool.h>
 
 /** \addtogroup syscall_t
  * \{
@@ -129,6 +130,7 @@ typedef uint32_t cy_p64_error_codes_t;
 
 /* Public APIs */
 cy_p64_error_codes_t cy_p64_syscall(uint32_t *cmd);
+bool cy_p64_is_crypto_enabled(void);
 
 
 #endif /* CY_P64_SYSCALL_H */
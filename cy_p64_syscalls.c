@@ -33,6 +33,7 @@
 #include <string.h>
 #include "cy_p64_syscalls.h"
 #include "cy_p64_jwt_policy.h"
+#include "cy_p64_rollback.h"
 
 
 /** AcquireResponse Syscall opcode */
@@ -54,6 +55,21 @@
 #define CY_P64_ROLL_BACK_COUNTER_READ               (0UL)
 #define CY_P64_ROLL_BACK_COUNTER_WRITE              (1UL)
 
+#if (CY_P64_PROV_DETAILS_CACHE_SIZE > 0u)
+/* The cached response of the Get Provision details syscall */
+typedef struct
+{
+    uint32_t id;
+    char *ptr;
+    uint32_t len;
+} cy_p64_prov_details_entry_t;
+
+static cy_p64_prov_details_entry_t cy_p64_prov_details_cache[CY_P64_PROV_DETAILS_CACHE_SIZE];
+static uint32_t cy_p64_prov_details_count = 0u;
+/* The entry replaced when the cache is full */
+static uint32_t cy_p64_prov_details_next = 0u;
+#endif /* CY_P64_PROV_DETAILS_CACHE_SIZE > 0u */
+
 
 /*******************************************************************************
 * Function Name: cy_p64_get_certificate
@@ -140,6 +156,78 @@ static cy_p64_error_codes_t cy_p64_get_certificate(const char *chain_of_trust, c
 }
 
 
+/*******************************************************************************
+* Function Name: cy_p64_prov_details_lookup
+****************************************************************************//**
+* Looks for the provisioning item in the cache.
+*
+* \param id         Item id.
+* \param ptr        The cached response string.
+* \param len        The cached length of the response string.
+* \return           true if the item is found.
+*
+*******************************************************************************/
+static bool cy_p64_prov_details_lookup(uint32_t id, char **ptr, uint32_t *len)
+{
+    bool found = false;
+#if (CY_P64_PROV_DETAILS_CACHE_SIZE > 0u)
+    uint32_t i;
+
+    for(i = 0u; (i < cy_p64_prov_details_count) && (!found); i++)
+    {
+        if(cy_p64_prov_details_cache[i].id == id)
+        {
+            *ptr = cy_p64_prov_details_cache[i].ptr;
+            *len = cy_p64_prov_details_cache[i].len;
+            found = true;
+        }
+    }
+#else
+    (void)id;
+    (void)ptr;
+    (void)len;
+#endif /* CY_P64_PROV_DETAILS_CACHE_SIZE > 0u */
+    return found;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_prov_details_store
+****************************************************************************//**
+* Stores the syscall response in the cache, replaces the entries round-robin
+* when the cache is full.
+*
+* \param id         Item id.
+* \param ptr        The response string.
+* \param len        The length of the response string.
+*
+*******************************************************************************/
+static void cy_p64_prov_details_store(uint32_t id, char *ptr, uint32_t len)
+{
+#if (CY_P64_PROV_DETAILS_CACHE_SIZE > 0u)
+    uint32_t i;
+
+    if(cy_p64_prov_details_count < CY_P64_PROV_DETAILS_CACHE_SIZE)
+    {
+        i = cy_p64_prov_details_count;
+        cy_p64_prov_details_count++;
+    }
+    else
+    {
+        i = cy_p64_prov_details_next;
+        cy_p64_prov_details_next = (cy_p64_prov_details_next + 1u) % CY_P64_PROV_DETAILS_CACHE_SIZE;
+    }
+    cy_p64_prov_details_cache[i].id = id;
+    cy_p64_prov_details_cache[i].ptr = ptr;
+    cy_p64_prov_details_cache[i].len = len;
+#else
+    (void)id;
+    (void)ptr;
+    (void)len;
+#endif /* CY_P64_PROV_DETAILS_CACHE_SIZE > 0u */
+}
+
+
 /** \addtogroup syscalls_api
  * \{
  */
@@ -162,6 +250,13 @@ static cy_p64_error_codes_t cy_p64_get_certificate(const char *chain_of_trust, c
 *                       the buffer is free/reused on the following call for read certificate.
 *                       To free the buffer explicitly call this function again with ptr=NULL and len=NULL.
 *             * 0x300 - CY_P64_POLICY_IMG_CERTIFICATE
+*
+* The responses for the flash-resident items (the policy, the templates and
+* the image certificate) are cached, the following calls with the same id do
+* not call the syscall. The key slots change with cy_p64_psa_store_key() and
+* cy_p64_keys_close_key() and are always read with the syscall. Call
+* cy_p64_provisioning_details_invalidate() after the device is reprovisioned.
+*
 * \param[out] ptr: The pointer to the response string. Can be NULL to read 'len' only.
 * \param[out] len: The length of the response string.
 *
@@ -173,6 +268,13 @@ cy_p64_error_codes_t cy_p64_get_provisioning_details(uint32_t id, char **ptr, ui
     cy_p64_error_codes_t status = CY_P64_INVALID;
     uint32_t syscall_cmd[2];
     uint32_t syscall_param[2];
+    char *resp_ptr = NULL;
+    uint32_t resp_len = 0u;
+    /* The key slots are mutable and the certificate buffers are allocated
+     * and freed by Secure FlashBoot on each call, so only the flash-resident
+     * items are cached */
+    bool cacheable = (((id >= CY_P64_POLICY_JWT) && (id <= CY_P64_POLICY_TEMPL_DEBUG)) ||
+                      (id == CY_P64_POLICY_IMG_CERTIFICATE));
     uint32_t sfb_ver = _FLD2VAL(CY_P64_SFB_VERSION, CY_GET_REG32(CY_P64_SFB_VERSION_ADDR));
 
     if(((id & ~CY_P64_POLICY_CERT_INDEX_MASK) == CY_P64_POLICY_CERTIFICATE) &&
@@ -183,23 +285,40 @@ cy_p64_error_codes_t cy_p64_get_provisioning_details(uint32_t id, char **ptr, ui
     }
     else
     {
-        syscall_cmd[0] = CY_P64_SYSCALL_OPCODE_GET_PROV_DETAILS;
-        syscall_cmd[1] = (uint32_t)syscall_param;
+        if(cacheable && cy_p64_prov_details_lookup(id, &resp_ptr, &resp_len))
+        {
+            status = CY_P64_SUCCESS;
+        }
+        else
+        {
+            syscall_cmd[0] = CY_P64_SYSCALL_OPCODE_GET_PROV_DETAILS;
+            syscall_cmd[1] = (uint32_t)syscall_param;
 
-        syscall_param[0] = id;
-        syscall_param[1] = 0U;
+            syscall_param[0] = id;
+            syscall_param[1] = 0U;
 
-        status = cy_p64_syscall(syscall_cmd);
+            status = cy_p64_syscall(syscall_cmd);
+
+            if(status == CY_P64_SUCCESS)
+            {
+                resp_ptr = (char *)syscall_param[1];
+                resp_len = syscall_param[0];
+                if(cacheable)
+                {
+                    cy_p64_prov_details_store(id, resp_ptr, resp_len);
+                }
+            }
+        }
 
         if(status == CY_P64_SUCCESS)
         {
             if(ptr != NULL)
             {
-                *ptr = (char *)syscall_param[1];
+                *ptr = resp_ptr;
             }
             if(len != NULL)
             {
-                *len = syscall_param[0];
+                *len = resp_len;
             }
         }
     }
@@ -208,6 +327,23 @@ cy_p64_error_codes_t cy_p64_get_provisioning_details(uint32_t id, char **ptr, ui
 }
 
 
+/*******************************************************************************
+* Function Name: cy_p64_provisioning_details_invalidate
+****************************************************************************//**
+*
+* Drops all responses cached by cy_p64_get_provisioning_details(). Call it after
+* the provisioning data is changed, the following calls read it with the syscall.
+*
+*******************************************************************************/
+void cy_p64_provisioning_details_invalidate(void)
+{
+#if (CY_P64_PROV_DETAILS_CACHE_SIZE > 0u)
+    cy_p64_prov_details_count = 0u;
+    cy_p64_prov_details_next = 0u;
+#endif /* CY_P64_PROV_DETAILS_CACHE_SIZE > 0u */
+}
+
+
 /*******************************************************************************
 * Function Name: cy_p64_access_port_control
 ****************************************************************************//**
@@ -363,6 +499,9 @@ cy_p64_error_codes_t cy_p64_update_rollback_counter(uint32_t number, uint32_t va
 
     status = cy_p64_syscall(syscall_cmd);
 
+    /* The value in the shadow table is not valid anymore */
+    cy_p64_rollback_shadow_invalidate(number);
+
     return status;
 }
 
@@ -96,6 +96,14 @@
 /** Image certificate */
 #define CY_P64_POLICY_IMG_CERTIFICATE   (0x300U)
 
+/** The number of the provisioning items kept by the cy_p64_get_provisioning_details()
+ * cache, 0 disables the cache. Only the policy, the policy templates and the image
+ * certificate are cached, the key slots and the certificates are always read
+ * with the syscall. */
+#ifndef CY_P64_PROV_DETAILS_CACHE_SIZE
+#define CY_P64_PROV_DETAILS_CACHE_SIZE  (8u)
+#endif /* CY_P64_PROV_DETAILS_CACHE_SIZE */
+
 /** \} */
 
 /** \addtogroup syscalls_t
@@ -124,6 +132,7 @@ typedef enum {
 
 /* Public APIs */
 cy_p64_error_codes_t cy_p64_get_provisioning_details(uint32_t id, char **ptr, uint32_t *len);
+void cy_p64_provisioning_details_invalidate(void);
 cy_p64_error_codes_t cy_p64_access_port_control(cy_p64_ap_name_t ap, cy_p64_ap_control_t control);
 cy_p64_error_codes_t cy_p64_acquire_response(void);
 void cy_p64_acquire_test_bit_loop(void);
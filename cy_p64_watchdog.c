@@ -26,19 +26,50 @@
 * \brief
 *  This library implements the watchdog functionality.
 *
+*  The long library operations (JSON parsing, base64 decoding, flash
+*  programming and syscall waits) call cy_p64_wdg_heartbeat(), which clears
+*  the running WDT at most once per heartbeat interval measured by the WDT
+*  counter. The policy timeout can be tight without resets during this work.
+*
+*  The software watchdog channels monitor several tasks with one hardware WDT.
+*  Each task registers a channel with its own deadline and checks in
+*  periodically. The heartbeat clears the WDT only while every active channel
+*  has checked in within its deadline. When a channel misses its deadline the
+*  WDT is not cleared anymore, and the channel number is stored in the
+*  retained RAM, so cy_p64_wdg_channel_get_starved() reports it after the
+*  WDT reset.
+*
 * \{
 *   \defgroup watchdog_api Functions
+*   \defgroup watchdog_macros Macros
+*   \defgroup watchdog_t Data Structures
 * \}
 *******************************************************************************/
 
 #include <stdbool.h>
 #include "cy_utils.h"
+#include "cy_syslib.h"
 #include "cy_p64_watchdog.h"
 
 
 /** Maximum number of ignore bits */
 #define CY_P64_WDT_MAX_IGNORE_BITS      (12u)
 
+/** The retained starvation record is valid */
+#define CY_P64_WDG_STARVED_MAGIC        (0x57444753u)
+
+typedef struct {
+    uint32_t deadline;              /** The maximum WDT counter ticks between two check-ins */
+    uint64_t checkin;               /** The timestamp of the last check-in */
+    bool active;                    /** The channel is registered */
+} cy_p64_wdg_channel_t;
+
+typedef struct {
+    uint32_t magic;                 /** \ref CY_P64_WDG_STARVED_MAGIC if the record is valid */
+    uint32_t channel;               /** The channel which missed its deadline */
+    uint32_t channel_inv;           /** The inverted channel number */
+} cy_p64_wdg_starved_t;
+
 typedef struct {
     uint16_t min_period_ms;         /** The minimum period in milliseconds that can be represented with this many ignored bits */
     uint16_t round_threshold_ms;    /** The timeout threshold in milliseconds, from which to round up to the minimum period */
@@ -70,6 +101,65 @@ static const cy_p64_wdg_ignore_bits_data_t cy_p64_wdg_ignore_data[CY_P64_WDT_MAX
 static bool cy_p64_wdg_initialized = false;
 static bool cy_p64_wdg_pdl_initialized = false;
 
+/* The WDT counter ticks between two clears by the heartbeat */
+static uint32_t cy_p64_wdg_heartbeat_ticks = CY_P64_WDG_HEARTBEAT_TICKS;
+/* The timestamp of the previous clear by the heartbeat */
+static uint64_t cy_p64_wdg_heartbeat_time = 0u;
+
+/* The 16-bit WDT counter extended to 64 bits and its last read value */
+static uint64_t cy_p64_wdg_ticks = 0u;
+static uint32_t cy_p64_wdg_last_count = 0u;
+
+static cy_p64_wdg_channel_t cy_p64_wdg_channels[CY_P64_WDG_CHANNEL_COUNT];
+/* A channel has missed its deadline, the WDT is not cleared anymore */
+static bool cy_p64_wdg_starving = false;
+
+/* The starvation record survives the WDT reset */
+CY_P64_WDG_RETAINED static cy_p64_wdg_starved_t cy_p64_wdg_starved;
+
+
+/*******************************************************************************
+* Function Name: cy_p64_wdg_update_ticks
+****************************************************************************//**
+* Adds the WDT counter ticks elapsed since the previous call to the 64-bit
+* timestamp. Call with the interrupts disabled.
+*******************************************************************************/
+static void cy_p64_wdg_update_ticks(void)
+{
+    uint32_t count = Cy_WDT_GetCount();
+
+    cy_p64_wdg_ticks += CY_LO16(count - cy_p64_wdg_last_count);
+    cy_p64_wdg_last_count = count;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_wdg_channels_alive
+****************************************************************************//**
+* Checks the deadlines of the active channels, records the first channel
+* which missed its deadline. Call with the interrupts disabled.
+*
+* \return "true" if all active channels have checked in within their deadlines.
+*******************************************************************************/
+static bool cy_p64_wdg_channels_alive(void)
+{
+    uint32_t i;
+
+    for (i = 0u; (i < CY_P64_WDG_CHANNEL_COUNT) && !cy_p64_wdg_starving; i++)
+    {
+        if (cy_p64_wdg_channels[i].active &&
+            ((cy_p64_wdg_ticks - cy_p64_wdg_channels[i].checkin) > (uint64_t)cy_p64_wdg_channels[i].deadline))
+        {
+            cy_p64_wdg_starving = true;
+            cy_p64_wdg_starved.channel = i;
+            cy_p64_wdg_starved.channel_inv = ~i;
+            cy_p64_wdg_starved.magic = CY_P64_WDG_STARVED_MAGIC;
+        }
+    }
+
+    return !cy_p64_wdg_starving;
+}
+
 /*******************************************************************************
 * Function Prototypes
 ****************************************************************************//**
@@ -104,20 +194,22 @@ static bool cy_p64_wdg_pdl_initialized = false;
 *******************************************************************************/
 cy_p64_error_codes_t cy_p64_wdg_init(uint32_t *timeout_ms)
 {
-    uint8_t ignore_bits;
+    cy_p64_wdg_config_t config;
     cy_p64_error_codes_t ret;
 
-    if ((*timeout_ms == 0u) || (*timeout_ms > cy_p64_wdg_max_timeout_ms()))
+    if (cy_p64_wdg_initialized)
     {
         ret = CY_P64_INVALID;
     }
-    else if (cy_p64_wdg_initialized)
+    else
     {
-        ret = CY_P64_INVALID;
+        ret = cy_p64_wdg_config_init(&config, *timeout_ms);
     }
-    else
+
+    if (ret == CY_P64_SUCCESS)
     {
         cy_p64_wdg_initialized = true;
+        *timeout_ms = config.timeout_ms;
 
         if (!cy_p64_wdg_pdl_initialized)
         {
@@ -127,21 +219,65 @@ cy_p64_error_codes_t cy_p64_wdg_init(uint32_t *timeout_ms)
 
         cy_p64_wdg_stop();
 
+        Cy_WDT_SetIgnoreBits(config.ignore_bits);
+
+        Cy_WDT_SetMatch(CY_LO16(config.match_delta + Cy_WDT_GetCount()));
+
+        cy_p64_wdg_heartbeat_ticks = config.heartbeat_ticks;
+        cy_p64_wdg_update_ticks();
+        cy_p64_wdg_heartbeat_time = cy_p64_wdg_ticks;
+    }
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_wdg_config_init
+****************************************************************************//**
+*
+* Precomputes the WDT configuration for the timeout: the ignore bits, the match
+* delta and the heartbeat interval. Prepare the configurations once, e.g. one
+* per processing phase, then re-arm the WDT with
+* cy_p64_wdg_kick_with_deadline() without the calculations.
+*
+* \param config     The configuration to fill.
+* \param timeout_ms The time in milliseconds before the WDT times out, it is
+*                   rounded up as by cy_p64_wdg_init() (see
+*                   cy_p64_wdg_config_t::timeout_ms).
+*
+* \return     \ref CY_P64_SUCCESS for success or \ref CY_P64_INVALID if the
+*             timeout is out of range.
+*
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_wdg_config_init(cy_p64_wdg_config_t *config, uint32_t timeout_ms)
+{
+    uint8_t ignore_bits;
+    uint32_t timeout = timeout_ms;
+    cy_p64_error_codes_t ret;
+
+    if ((config == NULL) || (timeout == 0u) || (timeout > cy_p64_wdg_max_timeout_ms()))
+    {
+        ret = CY_P64_INVALID;
+    }
+    else
+    {
         for (ignore_bits = 0; ignore_bits <= CY_P64_WDT_MAX_IGNORE_BITS; ignore_bits++)
         {
-            if (*timeout_ms >= cy_p64_wdg_ignore_data[ignore_bits].round_threshold_ms)
+            if (timeout >= cy_p64_wdg_ignore_data[ignore_bits].round_threshold_ms)
             {
-                if (*timeout_ms < cy_p64_wdg_ignore_data[ignore_bits].min_period_ms)
+                if (timeout < cy_p64_wdg_ignore_data[ignore_bits].min_period_ms)
                 {
-                    *timeout_ms = cy_p64_wdg_ignore_data[ignore_bits].min_period_ms;
+                    timeout = cy_p64_wdg_ignore_data[ignore_bits].min_period_ms;
                 }
                 break;
             }
         }
 
-        Cy_WDT_SetIgnoreBits(ignore_bits);
-
-        Cy_WDT_SetMatch(CY_LO16((*timeout_ms * 32768U / 1000U) - (1UL << (17U - ignore_bits)) + Cy_WDT_GetCount()));
+        config->timeout_ms = timeout;
+        config->ignore_bits = ignore_bits;
+        config->match_delta = CY_LO16((timeout * 32768U / 1000U) - (1UL << (17U - ignore_bits)));
+        config->heartbeat_ticks = (timeout * 32768U / 1000U) / CY_P64_WDG_HEARTBEAT_DIVIDER;
 
         ret = CY_P64_SUCCESS;
     }
@@ -150,6 +286,51 @@ cy_p64_error_codes_t cy_p64_wdg_init(uint32_t *timeout_ms)
 }
 
 
+/*******************************************************************************
+* Function Name: cy_p64_wdg_kick_with_deadline
+****************************************************************************//**
+*
+* Clears the WDT and sets its next timeout to the configuration timeout counted
+* from now: programs the match relative to the current WDT counter value. The
+* ignore bits are written only if they differ from the current ones. The
+* heartbeat interval of the configuration is applied as well.
+*
+* If software watchdog channels are registered, the WDT is cleared only while
+* every active channel has checked in within its deadline, as by
+* cy_p64_wdg_heartbeat().
+*
+* \param config     The configuration prepared by cy_p64_wdg_config_init().
+*
+*******************************************************************************/
+void cy_p64_wdg_kick_with_deadline(const cy_p64_wdg_config_t *config)
+{
+    uint32_t interrupt_state;
+
+    if (config != NULL)
+    {
+        interrupt_state = Cy_SysLib_EnterCriticalSection();
+
+        Cy_WDT_Unlock();
+        if (Cy_WDT_GetIgnoreBits() != config->ignore_bits)
+        {
+            Cy_WDT_SetIgnoreBits(config->ignore_bits);
+        }
+        Cy_WDT_SetMatch(CY_LO16(config->match_delta + Cy_WDT_GetCount()));
+        Cy_WDT_Lock();
+
+        cy_p64_wdg_heartbeat_ticks = config->heartbeat_ticks;
+        cy_p64_wdg_update_ticks();
+        if (cy_p64_wdg_channels_alive())
+        {
+            cy_p64_wdg_kick();
+            cy_p64_wdg_heartbeat_time = cy_p64_wdg_ticks;
+        }
+
+        Cy_SysLib_ExitCriticalSection(interrupt_state);
+    }
+}
+
+
 /*******************************************************************************
 * Function Name: cy_p64_wdg_free
 ****************************************************************************//**
@@ -210,4 +391,265 @@ uint32_t cy_p64_wdg_max_timeout_ms(void)
     return ((WDT_MAX_MATCH_VALUE + (1UL << 17U)) * 1000U / 32768U);
 }
 
+
+/*******************************************************************************
+* Function Name: cy_p64_wdg_heartbeat
+****************************************************************************//**
+*
+* Clears the WDT if it is enabled and the heartbeat interval has elapsed since
+* the previous clear by this function. The interval is a part of the timeout
+* set by cy_p64_wdg_init() (see \ref CY_P64_WDG_HEARTBEAT_DIVIDER), or
+* \ref CY_P64_WDG_HEARTBEAT_TICKS before it is called. The long library
+* operations call this function at bounded intervals, the application can
+* call it from its own loops as well.
+*
+* If software watchdog channels are registered, the WDT is cleared only while
+* every active channel has checked in within its deadline.
+*
+* \note
+* The WDT counter is 16-bit, the calls must be less than 2 seconds apart.
+*
+*******************************************************************************/
+void cy_p64_wdg_heartbeat(void)
+{
+    uint32_t interrupt_state;
+
+    if (cy_p64_wdg_is_enabled())
+    {
+        interrupt_state = Cy_SysLib_EnterCriticalSection();
+
+        cy_p64_wdg_update_ticks();
+        if (((cy_p64_wdg_ticks - cy_p64_wdg_heartbeat_time) >= (uint64_t)cy_p64_wdg_heartbeat_ticks) &&
+            cy_p64_wdg_channels_alive())
+        {
+            cy_p64_wdg_kick();
+            cy_p64_wdg_heartbeat_time = cy_p64_wdg_ticks;
+        }
+
+        Cy_SysLib_ExitCriticalSection(interrupt_state);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_wdg_timestamp
+****************************************************************************//**
+*
+* Returns the 32768 Hz timestamp: the 16-bit WDT counter extended to 64 bits.
+* The WDT counter is clocked by the ILO, so it keeps counting in the low-power
+* modes where the DWT cycle counter stops. Convert the timestamp differences
+* with \ref CY_P64_WDG_TICKS_TO_US.
+*
+* \note
+* The WDT must be enabled. The timestamp is extended on each call of this
+* function, cy_p64_wdg_heartbeat() or cy_p64_wdg_channel_checkin(). The
+* counter wraps every 2 seconds (\ref CY_P64_WDG_COUNTER_PERIOD) and the
+* wraps between two calls cannot be detected, so these calls must be less
+* than 2 seconds apart. The WDT interrupt cannot extend the counter, clearing
+* it also clears the watchdog. After a longer sleep call
+* cy_p64_wdg_timestamp_sleep() with the sleep time of the wake-up timer,
+* otherwise the timestamp misses whole counter periods.
+*
+* \return        The timestamp in WDT counter ticks.
+*
+*******************************************************************************/
+uint64_t cy_p64_wdg_timestamp(void)
+{
+    uint64_t ret;
+    uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
+
+    cy_p64_wdg_update_ticks();
+    ret = cy_p64_wdg_ticks;
+
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_wdg_timestamp_sleep
+****************************************************************************//**
+*
+* Extends the timestamp over a sleep longer than the WDT counter period. The
+* WDT counter keeps the exact ticks within the period, \p sleep_ms measured
+* by the wake-up source (e.g. the MCWDT or RTC that ended the sleep) restores
+* the number of the lost counter periods.
+*
+* Call cy_p64_wdg_timestamp() right before the sleep and this function right
+* after the wake-up, before the other WDT functions. \p sleep_ms must be
+* accurate to 1 second.
+*
+* \param sleep_ms   The time spent in the sleep in milliseconds.
+*
+*******************************************************************************/
+void cy_p64_wdg_timestamp_sleep(uint32_t sleep_ms)
+{
+    uint64_t sleep_ticks = CY_P64_WDG_US_TO_TICKS((uint64_t)sleep_ms * 1000u);
+    uint32_t interrupt_state = Cy_SysLib_EnterCriticalSection();
+    uint32_t count = Cy_WDT_GetCount();
+    uint32_t elapsed = CY_LO16(count - cy_p64_wdg_last_count);
+    uint64_t periods = 0u;
+
+    if (sleep_ticks > (uint64_t)elapsed)
+    {
+        /* The nearest number of the whole periods missed by the counter */
+        periods = (sleep_ticks - elapsed + (CY_P64_WDG_COUNTER_PERIOD / 2u)) / CY_P64_WDG_COUNTER_PERIOD;
+    }
+
+    cy_p64_wdg_ticks += (uint64_t)elapsed + (periods * CY_P64_WDG_COUNTER_PERIOD);
+    cy_p64_wdg_last_count = count;
+
+    Cy_SysLib_ExitCriticalSection(interrupt_state);
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_wdg_channel_register
+****************************************************************************//**
+*
+* Registers a software watchdog channel. The channel must check in with
+* cy_p64_wdg_channel_checkin() at least once per \p timeout_ms, the first
+* deadline starts now.
+*
+* \param timeout_ms The channel deadline in milliseconds.
+* \param channel    The registered channel number.
+*
+* \return     \ref CY_P64_SUCCESS for success or \ref CY_P64_INVALID if the
+*             timeout is 0 or all \ref CY_P64_WDG_CHANNEL_COUNT channels are used.
+*
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_wdg_channel_register(uint32_t timeout_ms, uint32_t *channel)
+{
+    cy_p64_error_codes_t ret = CY_P64_INVALID;
+    uint32_t interrupt_state;
+    uint32_t i;
+
+    if ((channel != NULL) && (timeout_ms != 0u) && (timeout_ms <= (UINT32_MAX / 32768U)))
+    {
+        interrupt_state = Cy_SysLib_EnterCriticalSection();
+
+        cy_p64_wdg_update_ticks();
+        for (i = 0u; (i < CY_P64_WDG_CHANNEL_COUNT) && (ret != CY_P64_SUCCESS); i++)
+        {
+            if (!cy_p64_wdg_channels[i].active)
+            {
+                cy_p64_wdg_channels[i].deadline = timeout_ms * 32768U / 1000U;
+                cy_p64_wdg_channels[i].checkin = cy_p64_wdg_ticks;
+                cy_p64_wdg_channels[i].active = true;
+                *channel = i;
+                ret = CY_P64_SUCCESS;
+            }
+        }
+
+        Cy_SysLib_ExitCriticalSection(interrupt_state);
+    }
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_wdg_channel_unregister
+****************************************************************************//**
+*
+* Unregisters the software watchdog channel, its deadline is not checked
+* anymore.
+*
+* \param channel    The channel number.
+*
+* \return     \ref CY_P64_SUCCESS for success or \ref CY_P64_INVALID if the
+*             channel is not registered.
+*
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_wdg_channel_unregister(uint32_t channel)
+{
+    cy_p64_error_codes_t ret = CY_P64_INVALID;
+
+    if ((channel < CY_P64_WDG_CHANNEL_COUNT) && cy_p64_wdg_channels[channel].active)
+    {
+        cy_p64_wdg_channels[channel].active = false;
+        ret = CY_P64_SUCCESS;
+    }
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_wdg_channel_checkin
+****************************************************************************//**
+*
+* Reports that the task of the channel is alive and starts its next deadline,
+* then calls cy_p64_wdg_heartbeat().
+*
+* \param channel    The channel number.
+*
+* \return     \ref CY_P64_SUCCESS for success or \ref CY_P64_INVALID if the
+*             channel is not registered.
+*
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_wdg_channel_checkin(uint32_t channel)
+{
+    cy_p64_error_codes_t ret = CY_P64_INVALID;
+    uint32_t interrupt_state;
+
+    if ((channel < CY_P64_WDG_CHANNEL_COUNT) && cy_p64_wdg_channels[channel].active)
+    {
+        interrupt_state = Cy_SysLib_EnterCriticalSection();
+
+        cy_p64_wdg_update_ticks();
+        cy_p64_wdg_channels[channel].checkin = cy_p64_wdg_ticks;
+
+        Cy_SysLib_ExitCriticalSection(interrupt_state);
+
+        cy_p64_wdg_heartbeat();
+        ret = CY_P64_SUCCESS;
+    }
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_wdg_channel_get_starved
+****************************************************************************//**
+*
+* Gets the channel which missed its deadline before the last WDT reset. The
+* record is kept in the retained RAM (see \ref CY_P64_WDG_RETAINED) until
+* cy_p64_wdg_channel_clear_starved() is called.
+*
+* \param channel    The channel number.
+*
+* \return     \ref CY_P64_SUCCESS if the record is valid or \ref CY_P64_INVALID
+*             if no channel has starved.
+*
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_wdg_channel_get_starved(uint32_t *channel)
+{
+    cy_p64_error_codes_t ret = CY_P64_INVALID;
+
+    if ((channel != NULL) && (cy_p64_wdg_starved.magic == CY_P64_WDG_STARVED_MAGIC) &&
+        (cy_p64_wdg_starved.channel == ~cy_p64_wdg_starved.channel_inv))
+    {
+        *channel = cy_p64_wdg_starved.channel;
+        ret = CY_P64_SUCCESS;
+    }
+
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_wdg_channel_clear_starved
+****************************************************************************//**
+*
+* Clears the starvation record in the retained RAM.
+*
+*******************************************************************************/
+void cy_p64_wdg_channel_clear_starved(void)
+{
+    cy_p64_wdg_starved.magic = 0u;
+}
+
 /** \} */
@@ -25,12 +25,81 @@
 #include "cy_wdt.h"
 
 
+/** \addtogroup watchdog_macros
+ * \{
+ */
+
+/** The frequency of the WDT counter and cy_p64_wdg_timestamp() in Hz */
+#define CY_P64_WDG_TICK_HZ              (32768u)
+
+/** Converts the WDT counter ticks to microseconds (1000000 / 32768 = 15625 / 512) */
+#define CY_P64_WDG_TICKS_TO_US(ticks)   (((uint64_t)(ticks) * 15625u) / 512u)
+
+/** The WDT counter period in ticks: the timestamp loses whole periods when it
+ * is not updated for this long, see cy_p64_wdg_timestamp_sleep() */
+#define CY_P64_WDG_COUNTER_PERIOD       (0x10000u)
+
+/** Converts microseconds to the WDT counter ticks, rounded down */
+#define CY_P64_WDG_US_TO_TICKS(us)      (((uint64_t)(us) * 512u) / 15625u)
+
+/** The number of heartbeats per WDT timeout set by cy_p64_wdg_init(): the
+ * heartbeat clears the WDT when this part of the timeout has elapsed since
+ * the previous clear */
+#ifndef CY_P64_WDG_HEARTBEAT_DIVIDER
+#define CY_P64_WDG_HEARTBEAT_DIVIDER    (4u)
+#endif /* CY_P64_WDG_HEARTBEAT_DIVIDER */
+
+/** The heartbeat interval in WDT counter ticks (32768 Hz) used until
+ * cy_p64_wdg_init() is called, e.g. when the WDT is started by
+ * CypressBootloader with the policy timeout */
+#ifndef CY_P64_WDG_HEARTBEAT_TICKS
+#define CY_P64_WDG_HEARTBEAT_TICKS      (3277u) /* 100 ms */
+#endif /* CY_P64_WDG_HEARTBEAT_TICKS */
+
+/** The number of software watchdog channels */
+#ifndef CY_P64_WDG_CHANNEL_COUNT
+#define CY_P64_WDG_CHANNEL_COUNT        (4u)
+#endif /* CY_P64_WDG_CHANNEL_COUNT */
+
+/** Places the starvation record of the software watchdog channels in the RAM
+ * which is not initialized at startup, so it survives the WDT reset */
+#ifndef CY_P64_WDG_RETAINED
+#define CY_P64_WDG_RETAINED             CY_NOINIT
+#endif /* CY_P64_WDG_RETAINED */
+
+/** \} */
+
+/** \addtogroup watchdog_t
+ * \{
+ */
+
+/** The precomputed WDT configuration, see cy_p64_wdg_config_init() */
+typedef struct
+{
+    uint32_t timeout_ms;        /**< The timeout rounded to the WDT resolution in milliseconds */
+    uint32_t heartbeat_ticks;   /**< The heartbeat interval in WDT counter ticks */
+    uint16_t match_delta;       /**< The match value relative to the current WDT counter */
+    uint8_t ignore_bits;        /**< The number of the ignored upper WDT counter bits */
+} cy_p64_wdg_config_t;
+
+/** \} */
+
 /* Public APIs */
 cy_p64_error_codes_t cy_p64_wdg_init(uint32_t *timeout_ms);
+cy_p64_error_codes_t cy_p64_wdg_config_init(cy_p64_wdg_config_t *config, uint32_t timeout_ms);
+void cy_p64_wdg_kick_with_deadline(const cy_p64_wdg_config_t *config);
 void cy_p64_wdg_free(void);
 void cy_p64_wdg_start(void);
 void cy_p64_wdg_stop(void);
 uint32_t cy_p64_wdg_max_timeout_ms(void);
+void cy_p64_wdg_heartbeat(void);
+uint64_t cy_p64_wdg_timestamp(void);
+void cy_p64_wdg_timestamp_sleep(uint32_t sleep_ms);
+cy_p64_error_codes_t cy_p64_wdg_channel_register(uint32_t timeout_ms, uint32_t *channel);
+cy_p64_error_codes_t cy_p64_wdg_channel_unregister(uint32_t channel);
+cy_p64_error_codes_t cy_p64_wdg_channel_checkin(uint32_t channel);
+cy_p64_error_codes_t cy_p64_wdg_channel_get_starved(uint32_t *channel);
+void cy_p64_wdg_channel_clear_starved(void);
 
 
 /** \addtogroup watchdog_api
@@ -0,0 +1,36 @@
+/***************************************************************************//**
+* \file cy_p64_benchmark_host.c
+* \version 1.0
+*
+* \brief
+* The host entry point of the benchmark suite. Prints the CSV to stdout.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "cy_p64_benchmark.h"
+
+static void cy_p64_benchmark_host_print(const char *line)
+{
+    (void)puts(line);
+}
+
+int main(void)
+{
+    cy_p64_error_codes_t ret = cy_p64_benchmark_run(cy_p64_benchmark_host_print);
+
+    if(ret != CY_P64_SUCCESS)
+    {
+        (void)fprintf(stderr, "benchmark failed: 0x%08lX\n", (unsigned long)ret);
+    }
+
+    return (ret == CY_P64_SUCCESS) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
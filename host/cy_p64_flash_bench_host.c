@@ -0,0 +1,195 @@
+/***************************************************************************//**
+* \file cy_p64_flash_bench_host.c
+* \version 1.0
+*
+* \brief
+* The host flash benchmark. Runs the image update scenarios on the flash
+* simulator and prints the flash operation counters, the modeled flash time
+* and the worst row wear of each scenario as CSV.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cy_p64_image.h"
+#include "cy_p64_mcuboot.h"
+#include "cy_p64_flash_sim.h"
+
+/* The upgrade slot used by the scenarios */
+#define CY_P64_FLASH_BENCH_SLOT_ADDR    (CY_FLASH_BASE + 0x00050000u)
+#define CY_P64_FLASH_BENCH_SLOT_SIZE    (0x00050000u)
+
+/* The size of the image written by the upgrade scenarios */
+#define CY_P64_FLASH_BENCH_IMAGE_SIZE   (0x00030000u)
+
+/* The size of one DFU transfer passed to cy_p64_image_upgrade_write() */
+#define CY_P64_FLASH_BENCH_CHUNK_SIZE   (1024u)
+
+static uint8_t cy_p64_flash_bench_image[CY_P64_FLASH_BENCH_IMAGE_SIZE];
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_bench_report
+****************************************************************************//**
+* Prints the CSV line of the scenario and clears the counters.
+*******************************************************************************/
+static void cy_p64_flash_bench_report(const char *name, cy_p64_error_codes_t ret)
+{
+    cy_p64_flash_sim_stats_t stats;
+
+    cy_p64_flash_sim_get_stats(&stats);
+    (void)printf("%s,%lu,%lu,%lu,%lu,%lu,%llu,%lu,0x%08lX\n", name,
+                 (unsigned long)stats.row_erases, (unsigned long)stats.subsector_erases,
+                 (unsigned long)stats.row_programs, (unsigned long)stats.program_errors,
+                 (unsigned long)stats.busy_polls, (unsigned long long)(stats.busy_us / 1000u),
+                 (unsigned long)stats.max_wear, (unsigned long)ret);
+    cy_p64_flash_sim_clear_stats();
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_bench_confirm_cb
+****************************************************************************//**
+* Stores the status of the non-blocking confirm.
+*******************************************************************************/
+static void cy_p64_flash_bench_confirm_cb(cy_p64_error_codes_t status, void *arg)
+{
+    *(cy_p64_error_codes_t *)arg = status;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_bench_upgrade
+****************************************************************************//**
+* Writes the image to the upgrade slot as a DFU transfer would do and checks
+* the slot content and the trailer.
+*******************************************************************************/
+static cy_p64_error_codes_t cy_p64_flash_bench_upgrade(void)
+{
+    static cy_p64_image_upgrade_t ctx;
+    cy_p64_mcuboot_slot_t slot;
+    cy_p64_error_codes_t ret;
+    uint32_t offset;
+
+    ret = cy_p64_image_upgrade_begin(&ctx, CY_P64_FLASH_BENCH_SLOT_ADDR, CY_P64_FLASH_BENCH_SLOT_SIZE,
+                                     CY_P64_PSA_ALG_SHA_256);
+    for(offset = 0u; (ret == CY_P64_SUCCESS) && (offset < sizeof(cy_p64_flash_bench_image));
+        offset += CY_P64_FLASH_BENCH_CHUNK_SIZE)
+    {
+        ret = cy_p64_image_upgrade_write(&ctx, &cy_p64_flash_bench_image[offset], CY_P64_FLASH_BENCH_CHUNK_SIZE);
+    }
+    if(ret == CY_P64_SUCCESS)
+    {
+        /* The host syscall stand-in returns an empty digest */
+        ret = cy_p64_image_upgrade_finish(&ctx, cy_p64_flash_bench_image, 0u, true);
+    }
+    else
+    {
+        cy_p64_image_upgrade_abort(&ctx);
+    }
+
+    if((ret == CY_P64_SUCCESS) &&
+       (memcmp(cy_p64_flash_ptr(CY_P64_FLASH_BENCH_SLOT_ADDR), cy_p64_flash_bench_image,
+               sizeof(cy_p64_flash_bench_image)) != 0))
+    {
+        ret = CY_P64_INVALID;
+    }
+    if(ret == CY_P64_SUCCESS)
+    {
+        ret = cy_p64_mcuboot_slot_info(CY_P64_FLASH_BENCH_SLOT_ADDR, CY_P64_FLASH_BENCH_SLOT_SIZE, &slot);
+    }
+    if((ret == CY_P64_SUCCESS) &&
+       ((slot.magic != CY_P64_MCUBOOT_MAGIC_GOOD) || (slot.image_ok != CY_P64_MCUBOOT_FLAG_SET)))
+    {
+        ret = CY_P64_INVALID;
+    }
+
+    return ret;
+}
+
+
+int main(void)
+{
+    cy_p64_flash_writer_t writer;
+    cy_p64_error_codes_t ret;
+    cy_p64_error_codes_t status = CY_P64_INVALID;
+    uint32_t word;
+    uint32_t i;
+    bool failed = false;
+
+    for(i = 0u; i < sizeof(cy_p64_flash_bench_image); i++)
+    {
+        cy_p64_flash_bench_image[i] = (uint8_t)((i * 7u) + (i >> 9u));
+    }
+    cy_p64_flash_sim_reset();
+
+    (void)puts("scenario,row_erases,subsector_erases,row_programs,program_errors,busy_polls,busy_ms,max_wear,result");
+
+    /* Image OK written to the blank trailer, then found already set */
+    ret = cy_p64_confirm_image(CY_P64_FLASH_BENCH_SLOT_ADDR, CY_P64_FLASH_BENCH_SLOT_SIZE);
+    failed |= (ret != CY_P64_SUCCESS);
+    cy_p64_flash_bench_report("confirm", ret);
+    ret = cy_p64_confirm_image(CY_P64_FLASH_BENCH_SLOT_ADDR, CY_P64_FLASH_BENCH_SLOT_SIZE);
+    failed |= (ret != CY_P64_SUCCESS);
+    cy_p64_flash_bench_report("confirm_again", ret);
+
+    /* The non-blocking confirm on a cleared trailer */
+    cy_p64_flash_sim_reset();
+    ret = cy_p64_confirm_image_start(CY_P64_FLASH_BENCH_SLOT_ADDR, CY_P64_FLASH_BENCH_SLOT_SIZE,
+                                     cy_p64_flash_bench_confirm_cb, &status);
+    while(!cy_p64_confirm_image_poll())
+    {
+    }
+    if(ret == CY_P64_SUCCESS)
+    {
+        ret = status;
+    }
+    failed |= (ret != CY_P64_SUCCESS);
+    cy_p64_flash_bench_report("confirm_start", ret);
+
+    /* Word writes through the row buffer: 8 rows, then the same data again */
+    cy_p64_flash_writer_init(&writer);
+    ret = CY_P64_SUCCESS;
+    for(i = 0u; (ret == CY_P64_SUCCESS) && (i < (8u * CY_P64_FLASH_ROW_SIZE)); i += sizeof(word))
+    {
+        word = i;
+        ret = cy_p64_flash_writer_write(&writer, CY_P64_FLASH_BENCH_SLOT_ADDR + i, (const uint8_t *)&word,
+                                        sizeof(word));
+    }
+    if(ret == CY_P64_SUCCESS)
+    {
+        ret = cy_p64_flash_writer_flush(&writer);
+    }
+    failed |= (ret != CY_P64_SUCCESS);
+    cy_p64_flash_bench_report("writer_words", ret);
+    for(i = 0u; (ret == CY_P64_SUCCESS) && (i < (8u * CY_P64_FLASH_ROW_SIZE)); i += sizeof(word))
+    {
+        word = i;
+        ret = cy_p64_flash_writer_write(&writer, CY_P64_FLASH_BENCH_SLOT_ADDR + i, (const uint8_t *)&word,
+                                        sizeof(word));
+    }
+    if(ret == CY_P64_SUCCESS)
+    {
+        ret = cy_p64_flash_writer_flush(&writer);
+    }
+    failed |= (ret != CY_P64_SUCCESS);
+    cy_p64_flash_bench_report("writer_unchanged", ret);
+
+    /* The DFU upgrade over the previous content of the slot, twice */
+    ret = cy_p64_flash_bench_upgrade();
+    failed |= (ret != CY_P64_SUCCESS);
+    cy_p64_flash_bench_report("upgrade", ret);
+    ret = cy_p64_flash_bench_upgrade();
+    failed |= (ret != CY_P64_SUCCESS);
+    cy_p64_flash_bench_report("upgrade_again", ret);
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
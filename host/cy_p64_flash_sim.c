@@ -0,0 +1,387 @@
+/***************************************************************************//**
+* \file cy_p64_flash_sim.c
+* \version 1.0
+*
+* \brief
+* The host flash simulator, the backend of the flash access functions in the
+* host build (CY_P64_FLASH_SIM). The flash is a memory array initialized to
+* the erased value. Every operation is applied when it is started and is
+* reported as busy by the first cy_p64_flash_is_complete() call, so the poll
+* loops of the library are exercised. The simulator counts the operations,
+* their modeled time and the erases of each row (the wear).
+*
+* Programming a row which is not erased is counted as a program error and
+* ORs the data into the row, so a missing erase is visible in the flash
+* content as well.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cy_p64_flash_sim.h"
+
+#define CY_P64_FLASH_SIM_ROWS       (CY_P64_FLASH_SIM_SIZE / CY_P64_FLASH_ROW_SIZE)
+
+static uint8_t cy_p64_flash_sim_mem[CY_P64_FLASH_SIM_SIZE];
+static uint32_t cy_p64_flash_sim_wear[CY_P64_FLASH_SIM_ROWS];
+static cy_p64_flash_sim_stats_t cy_p64_flash_sim_stats;
+static bool cy_p64_flash_sim_busy = false;
+static cy_p64_error_codes_t cy_p64_flash_sim_status = CY_P64_SUCCESS;
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_sim_in_range
+****************************************************************************//**
+* Checks that the range is inside the simulated flash.
+*******************************************************************************/
+static bool cy_p64_flash_sim_in_range(uint32_t address, uint32_t size)
+{
+    return (address >= CY_FLASH_BASE) && ((address - CY_FLASH_BASE) <= CY_P64_FLASH_SIM_SIZE) &&
+           (size <= (CY_P64_FLASH_SIM_SIZE - (address - CY_FLASH_BASE)));
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_sim_erase
+****************************************************************************//**
+* Erases the aligned rows and updates their wear.
+*******************************************************************************/
+static void cy_p64_flash_sim_erase(uint32_t address, uint32_t size)
+{
+    uint32_t row = (address - CY_FLASH_BASE) / CY_P64_FLASH_ROW_SIZE;
+    uint32_t i;
+
+    (void)memset(&cy_p64_flash_sim_mem[address - CY_FLASH_BASE], (int)CY_P64_FLASH_SIM_ERASED_VAL, size);
+    for(i = 0u; i < (size / CY_P64_FLASH_ROW_SIZE); i++)
+    {
+        cy_p64_flash_sim_wear[row + i]++;
+        if(cy_p64_flash_sim_wear[row + i] > cy_p64_flash_sim_stats.max_wear)
+        {
+            cy_p64_flash_sim_stats.max_wear = cy_p64_flash_sim_wear[row + i];
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_sim_program
+****************************************************************************//**
+* Programs the row, counts a program error if it is not erased.
+*******************************************************************************/
+static void cy_p64_flash_sim_program(uint32_t address, const uint32_t *data)
+{
+    uint8_t *row = &cy_p64_flash_sim_mem[address - CY_FLASH_BASE];
+    const uint8_t *src = (const uint8_t *)data;
+    bool erased = true;
+    uint32_t i;
+
+    for(i = 0u; i < CY_P64_FLASH_ROW_SIZE; i++)
+    {
+        if(row[i] != CY_P64_FLASH_SIM_ERASED_VAL)
+        {
+            erased = false;
+        }
+        row[i] |= src[i];
+    }
+    if(!erased)
+    {
+        cy_p64_flash_sim_stats.program_errors++;
+    }
+    cy_p64_flash_sim_stats.row_programs++;
+    cy_p64_flash_sim_stats.busy_us += CY_P64_FLASH_SIM_ROW_PROGRAM_US;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_sim_start
+****************************************************************************//**
+* Checks the row operation parameters and the simulator state before
+* the operation.
+*******************************************************************************/
+static cy_p64_error_codes_t cy_p64_flash_sim_start(uint32_t address, uint32_t size)
+{
+    cy_p64_error_codes_t ret = CY_P64_INVALID_FLASH_OPERATION;
+
+    if((!cy_p64_flash_sim_busy) && ((address % size) == 0u) && cy_p64_flash_sim_in_range(address, size))
+    {
+        ret = CY_P64_SUCCESS;
+    }
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Prototypes
+****************************************************************************//**
+*
+*  \addtogroup flash_api
+*
+*  \{
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_sim_reset
+****************************************************************************//**
+* Erases the simulated flash and clears the wear and the operation counters.
+*******************************************************************************/
+void cy_p64_flash_sim_reset(void)
+{
+    (void)memset(cy_p64_flash_sim_mem, (int)CY_P64_FLASH_SIM_ERASED_VAL, sizeof(cy_p64_flash_sim_mem));
+    (void)memset(cy_p64_flash_sim_wear, 0, sizeof(cy_p64_flash_sim_wear));
+    cy_p64_flash_sim_busy = false;
+    cy_p64_flash_sim_clear_stats();
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_sim_clear_stats
+****************************************************************************//**
+* Clears the operation counters, the flash content and the wear are kept.
+*******************************************************************************/
+void cy_p64_flash_sim_clear_stats(void)
+{
+    (void)memset(&cy_p64_flash_sim_stats, 0, sizeof(cy_p64_flash_sim_stats));
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_sim_get_stats
+****************************************************************************//**
+* Gets the operation counters.
+*
+* \param[out] stats         The operation counters.
+*******************************************************************************/
+void cy_p64_flash_sim_get_stats(cy_p64_flash_sim_stats_t *stats)
+{
+    if(stats != NULL)
+    {
+        *stats = cy_p64_flash_sim_stats;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_sim_get_wear
+****************************************************************************//**
+* Gets the number of erases of the flash row.
+*
+* \param[in] address        An address inside the row.
+* \return     The number of erases, 0 for an address outside the flash.
+*******************************************************************************/
+uint32_t cy_p64_flash_sim_get_wear(uint32_t address)
+{
+    uint32_t ret = 0u;
+
+    if(cy_p64_flash_sim_in_range(address, 1u))
+    {
+        ret = cy_p64_flash_sim_wear[(address - CY_FLASH_BASE) / CY_P64_FLASH_ROW_SIZE];
+    }
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_sim_load
+****************************************************************************//**
+* Copies the data to the simulated flash as a programmer would do, without
+* counting the operations or the wear.
+*
+* \param[in] address        The flash address.
+* \param[in] data           The data.
+* \param[in] size           The size of the data in bytes.
+* \return     \ref CY_P64_SUCCESS for success or error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_flash_sim_load(uint32_t address, const void *data, uint32_t size)
+{
+    cy_p64_error_codes_t ret = CY_P64_INVALID_ADDR_OUT_OF_RANGE;
+
+    if(data == NULL)
+    {
+        ret = CY_P64_INVALID_ARGUMENT;
+    }
+    else if(cy_p64_flash_sim_in_range(address, size))
+    {
+        (void)memcpy(&cy_p64_flash_sim_mem[address - CY_FLASH_BASE], data, size);
+        ret = CY_P64_SUCCESS;
+    }
+    else
+    {
+        /* The range is outside the simulated flash */
+    }
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_ptr
+****************************************************************************//**
+* Returns the pointer to read the simulated flash at the address. A read
+* outside the flash is a bus fault on the device, the simulator aborts.
+*
+* \param[in] address        The flash address.
+* \return     The pointer to the simulated flash.
+*******************************************************************************/
+const uint8_t *cy_p64_flash_ptr(uint32_t address)
+{
+    if(!cy_p64_flash_sim_in_range(address, 1u))
+    {
+        (void)fprintf(stderr, "flash sim: read outside the flash at 0x%08lX\n", (unsigned long)address);
+        abort();
+    }
+    return &cy_p64_flash_sim_mem[address - CY_FLASH_BASE];
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_write_row
+****************************************************************************//**
+* Erases and programs the simulated flash row.
+*
+* \param[in] address        The row aligned flash address.
+* \param[in] data           The row data, \ref CY_P64_FLASH_ROW_SIZE bytes.
+* \return     \ref CY_P64_SUCCESS for success or error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_flash_write_row(uint32_t address, const uint32_t *data)
+{
+    cy_p64_error_codes_t ret = cy_p64_flash_sim_start(address, CY_P64_FLASH_ROW_SIZE);
+
+    if(ret == CY_P64_SUCCESS)
+    {
+        cy_p64_flash_sim_erase(address, CY_P64_FLASH_ROW_SIZE);
+        cy_p64_flash_sim_stats.row_erases++;
+        cy_p64_flash_sim_stats.busy_us += CY_P64_FLASH_SIM_ROW_ERASE_US;
+        cy_p64_flash_sim_program(address, data);
+    }
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_start_write
+****************************************************************************//**
+* Starts erasing and programming the simulated flash row.
+*
+* \param[in] address        The row aligned flash address.
+* \param[in] data           The row data.
+* \return     \ref CY_P64_SUCCESS if the operation is started or error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_flash_start_write(uint32_t address, const uint32_t *data)
+{
+    cy_p64_error_codes_t ret = cy_p64_flash_write_row(address, data);
+
+    if(ret == CY_P64_SUCCESS)
+    {
+        cy_p64_flash_sim_busy = true;
+        cy_p64_flash_sim_status = CY_P64_SUCCESS;
+    }
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_start_program
+****************************************************************************//**
+* Starts programming the simulated flash row.
+*
+* \param[in] address        The row aligned flash address.
+* \param[in] data           The row data.
+* \return     \ref CY_P64_SUCCESS if the operation is started or error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_flash_start_program(uint32_t address, const uint32_t *data)
+{
+    cy_p64_error_codes_t ret = cy_p64_flash_sim_start(address, CY_P64_FLASH_ROW_SIZE);
+
+    if(ret == CY_P64_SUCCESS)
+    {
+        cy_p64_flash_sim_program(address, data);
+        cy_p64_flash_sim_busy = true;
+        cy_p64_flash_sim_status = CY_P64_SUCCESS;
+    }
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_start_erase
+****************************************************************************//**
+* Starts erasing the simulated flash row or subsector.
+*
+* \param[in] address        The flash address aligned to \p size.
+* \param[in] size           \ref CY_P64_FLASH_ROW_SIZE or
+*                           \ref CY_P64_FLASH_SUBSECTOR_SIZE.
+* \return     \ref CY_P64_SUCCESS if the operation is started or error code.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_flash_start_erase(uint32_t address, uint32_t size)
+{
+    cy_p64_error_codes_t ret;
+
+    if((size != CY_P64_FLASH_ROW_SIZE) && (size != CY_P64_FLASH_SUBSECTOR_SIZE))
+    {
+        ret = CY_P64_INVALID_ARGUMENT;
+    }
+    else
+    {
+        ret = cy_p64_flash_sim_start(address, size);
+    }
+
+    if(ret == CY_P64_SUCCESS)
+    {
+        cy_p64_flash_sim_erase(address, size);
+        if(size == CY_P64_FLASH_SUBSECTOR_SIZE)
+        {
+            cy_p64_flash_sim_stats.subsector_erases++;
+            cy_p64_flash_sim_stats.busy_us += CY_P64_FLASH_SIM_SUBSECTOR_ERASE_US;
+        }
+        else
+        {
+            cy_p64_flash_sim_stats.row_erases++;
+            cy_p64_flash_sim_stats.busy_us += CY_P64_FLASH_SIM_ROW_ERASE_US;
+        }
+        cy_p64_flash_sim_busy = true;
+        cy_p64_flash_sim_status = CY_P64_SUCCESS;
+    }
+    return ret;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_flash_is_complete
+****************************************************************************//**
+* Checks the simulated non-blocking operation. The operation is reported as
+* busy once, then as complete.
+*
+* \param[out] status        The result of the complete operation.
+* \return     "true" if the operation is complete, "false" if it is in progress.
+*******************************************************************************/
+bool cy_p64_flash_is_complete(cy_p64_error_codes_t *status)
+{
+    bool ret = true;
+    static bool polled = false;
+
+    if(cy_p64_flash_sim_busy && !polled)
+    {
+        polled = true;
+        cy_p64_flash_sim_stats.busy_polls++;
+        ret = false;
+    }
+    else
+    {
+        polled = false;
+        cy_p64_flash_sim_busy = false;
+        if(status != NULL)
+        {
+            *status = cy_p64_flash_sim_status;
+        }
+    }
+    return ret;
+}
+
+/** \} */
@@ -0,0 +1,79 @@
+/***************************************************************************//**
+* \file cy_p64_flash_sim.h
+* \version 1.0
+*
+* \brief
+* This is the header file for the host flash simulator.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef CY_P64_FLASH_SIM_H
+#define CY_P64_FLASH_SIM_H
+
+#include <stdint.h>
+#include "cy_p64_flash.h"
+
+/** \addtogroup flash_macros
+ * \{
+ */
+
+/** The size of the simulated flash starting at CY_FLASH_BASE */
+#ifndef CY_P64_FLASH_SIM_SIZE
+#define CY_P64_FLASH_SIM_SIZE               (CY_FLASH_SIZE)
+#endif /* CY_P64_FLASH_SIM_SIZE */
+
+/** The value of the erased flash byte */
+#ifndef CY_P64_FLASH_SIM_ERASED_VAL
+#define CY_P64_FLASH_SIM_ERASED_VAL         (0x00u)
+#endif /* CY_P64_FLASH_SIM_ERASED_VAL */
+
+/** The modeled time of the row erase in microseconds */
+#ifndef CY_P64_FLASH_SIM_ROW_ERASE_US
+#define CY_P64_FLASH_SIM_ROW_ERASE_US       (11000u)
+#endif /* CY_P64_FLASH_SIM_ROW_ERASE_US */
+
+/** The modeled time of the subsector erase in microseconds */
+#ifndef CY_P64_FLASH_SIM_SUBSECTOR_ERASE_US
+#define CY_P64_FLASH_SIM_SUBSECTOR_ERASE_US (15000u)
+#endif /* CY_P64_FLASH_SIM_SUBSECTOR_ERASE_US */
+
+/** The modeled time of the row program in microseconds */
+#ifndef CY_P64_FLASH_SIM_ROW_PROGRAM_US
+#define CY_P64_FLASH_SIM_ROW_PROGRAM_US     (5000u)
+#endif /* CY_P64_FLASH_SIM_ROW_PROGRAM_US */
+
+/** \} */
+
+/** \addtogroup flash_t
+ * \{
+ */
+
+/** The flash operation counters of the simulator */
+typedef struct
+{
+    uint32_t row_erases;        /**< The number of row erases, including the erases of the row writes */
+    uint32_t subsector_erases;  /**< The number of subsector erases */
+    uint32_t row_programs;      /**< The number of row programs, including the programs of the row writes */
+    uint32_t program_errors;    /**< The number of rows programmed without an erase */
+    uint32_t busy_polls;        /**< The number of cy_p64_flash_is_complete() calls which returned "false" */
+    uint64_t busy_us;           /**< The modeled flash time of all operations in microseconds */
+    uint32_t max_wear;          /**< The largest number of erases of one row */
+} cy_p64_flash_sim_stats_t;
+
+/** \} */
+
+/* Public APIs */
+void cy_p64_flash_sim_reset(void);
+void cy_p64_flash_sim_clear_stats(void);
+void cy_p64_flash_sim_get_stats(cy_p64_flash_sim_stats_t *stats);
+uint32_t cy_p64_flash_sim_get_wear(uint32_t address);
+cy_p64_error_codes_t cy_p64_flash_sim_load(uint32_t address, const void *data, uint32_t size);
+
+#endif /* CY_P64_FLASH_SIM_H */
@@ -0,0 +1,216 @@
+/***************************************************************************//**
+* \file cy_p64_policy_host.c
+* \version 1.0
+*
+* \brief
+* The host policy parsing driver for profiling. Parses a provisioning policy
+* file (JSON, or the JWT packet as read from the device) with the library
+* parser and heap in a loop, looks up the image slots of the parsed policy
+* and prints the average time of each step as CSV. Run it under perf or
+* valgrind to profile the parsing and allocation paths:
+*
+*   cy_p64_policy_host <policy file> [iterations]
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_p64_cJSON.h"
+#include "cy_p64_jwt_policy.h"
+
+/* The default number of parse iterations */
+#define CY_P64_POLICY_HOST_ITERATIONS   (1000u)
+
+/* The image IDs looked up in the parsed policy */
+#define CY_P64_POLICY_HOST_MAX_IMAGE_ID (16u)
+
+
+/*******************************************************************************
+* Function Name: cy_p64_policy_host_now_us
+****************************************************************************//**
+* Returns the monotonic time in microseconds.
+*******************************************************************************/
+static uint64_t cy_p64_policy_host_now_us(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000u) + ((uint64_t)ts.tv_nsec / 1000u);
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_policy_host_read
+****************************************************************************//**
+* Reads the whole file to the NUL terminated buffer allocated by malloc().
+*******************************************************************************/
+static char *cy_p64_policy_host_read(const char *path, long *size)
+{
+    FILE *file = fopen(path, "rb");
+    char *buf = NULL;
+
+    if(file != NULL)
+    {
+        if((fseek(file, 0, SEEK_END) == 0) && ((*size = ftell(file)) > 0) && (fseek(file, 0, SEEK_SET) == 0))
+        {
+            buf = malloc((size_t)*size + 1u);
+            if((buf != NULL) && (fread(buf, 1u, (size_t)*size, file) != (size_t)*size))
+            {
+                free(buf);
+                buf = NULL;
+            }
+        }
+        (void)fclose(file);
+    }
+    if(buf != NULL)
+    {
+        buf[*size] = '\0';
+    }
+
+    return buf;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_policy_host_count
+****************************************************************************//**
+* Counts the items of the JSON tree.
+*******************************************************************************/
+static uint32_t cy_p64_policy_host_count(const cy_p64_cJSON *json)
+{
+    uint32_t count = 0u;
+
+    while(json != NULL)
+    {
+        count += 1u + cy_p64_policy_host_count(json->child);
+        json = json->next;
+    }
+
+    return count;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_policy_host_lookup
+****************************************************************************//**
+* Looks up the BOOT and UPGRADE slots of all image IDs, returns the number of
+* the slots found.
+*******************************************************************************/
+static uint32_t cy_p64_policy_host_lookup(const cy_p64_cJSON *json)
+{
+    uint32_t slots = 0u;
+    uint32_t address;
+    uint32_t size;
+    uint32_t id;
+
+    for(id = 0u; id <= CY_P64_POLICY_HOST_MAX_IMAGE_ID; id++)
+    {
+        if(cy_p64_policy_get_image_address_and_size(json, id, "BOOT", &address, &size) == CY_P64_SUCCESS)
+        {
+            slots++;
+        }
+        if(cy_p64_policy_get_image_address_and_size(json, id, "UPGRADE", &address, &size) == CY_P64_SUCCESS)
+        {
+            slots++;
+        }
+    }
+
+    return slots;
+}
+
+
+int main(int argc, char *argv[])
+{
+    cy_p64_error_codes_t ret = CY_P64_SUCCESS;
+    cy_p64_cJSON *json = NULL;
+    unsigned long iterations = CY_P64_POLICY_HOST_ITERATIONS;
+    uint64_t parse_us = 0u;
+    uint64_t lookup_us = 0u;
+    uint64_t delete_us = 0u;
+    uint64_t start;
+    uint32_t items = 0u;
+    uint32_t slots = 0u;
+    unsigned long i;
+    const char *text;
+    bool jwt;
+    char *buf;
+    long size = 0;
+
+    if((argc < 2) || (argc > 3) || ((argc == 3) && ((iterations = strtoul(argv[2], NULL, 0)) == 0u)))
+    {
+        (void)fprintf(stderr, "usage: %s <policy file> [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    buf = cy_p64_policy_host_read(argv[1], &size);
+    if(buf == NULL)
+    {
+        (void)fprintf(stderr, "cannot read %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    /* A JSON policy starts with an object, anything else is a JWT packet */
+    text = buf;
+    while((*text == ' ') || (*text == '\t') || (*text == '\r') || (*text == '\n'))
+    {
+        text++;
+    }
+    jwt = (*text != '{');
+
+    for(i = 0u; (i < iterations) && (ret == CY_P64_SUCCESS); i++)
+    {
+        start = cy_p64_policy_host_now_us();
+        if(jwt)
+        {
+            ret = cy_p64_decode_payload_data(text, &json);
+        }
+        else
+        {
+            json = cy_p64_cJSON_Parse(text);
+            ret = (json != NULL) ? CY_P64_SUCCESS : CY_P64_JWT_ERR_JSN_PARSE_FAIL;
+        }
+        parse_us += cy_p64_policy_host_now_us() - start;
+
+        if(ret == CY_P64_SUCCESS)
+        {
+            start = cy_p64_policy_host_now_us();
+            slots = cy_p64_policy_host_lookup(json);
+            lookup_us += cy_p64_policy_host_now_us() - start;
+
+            items = cy_p64_policy_host_count(json);
+
+            start = cy_p64_policy_host_now_us();
+            cy_p64_cJSON_Delete(json);
+            delete_us += cy_p64_policy_host_now_us() - start;
+        }
+    }
+
+    if(ret == CY_P64_SUCCESS)
+    {
+        (void)puts("file,format,bytes,items,slots,iterations,parse_us,lookup_us,delete_us");
+        (void)printf("%s,%s,%ld,%lu,%lu,%lu,%.2f,%.2f,%.2f\n", argv[1], jwt ? "jwt" : "json", size,
+                     (unsigned long)items, (unsigned long)slots, iterations,
+                     (double)parse_us / (double)iterations, (double)lookup_us / (double)iterations,
+                     (double)delete_us / (double)iterations);
+    }
+    else
+    {
+        (void)fprintf(stderr, "parse failed: 0x%08lX (build with a larger HEAP_SIZE for large policies)\n",
+                      (unsigned long)ret);
+    }
+
+    free(buf);
+
+    return (ret == CY_P64_SUCCESS) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,52 @@
+/***************************************************************************//**
+* \file cy_p64_syscall_host.c
+* \version 1.0
+*
+* \brief
+* The host stand-in for the Secure FlashBoot system call. Every call succeeds
+* without touching the parameters, so the host benchmark measures only the
+* cost of the wrapper functions.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "cy_p64_syscall.h"
+#include "cy_device.h"
+
+/** The device UID reported by the host */
+const SFLASH_Type cy_p64_host_sflash = { { 0x01u, 0x02u, 0x03u }, 0x04u, 0x05u, 0x06u, 0x07u, 0x08u, 0x09u, 0x0Au, 0x0Bu };
+
+
+/*******************************************************************************
+* Function Name: cy_p64_is_crypto_enabled
+****************************************************************************//**
+* There is no Crypto block on the host.
+*
+* \return     false.
+*******************************************************************************/
+bool cy_p64_is_crypto_enabled(void)
+{
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: cy_p64_syscall
+****************************************************************************//**
+* Completes the system call immediately.
+*
+* \param cmd    The system call command, ignored.
+* \return       \ref CY_P64_SUCCESS.
+*******************************************************************************/
+cy_p64_error_codes_t cy_p64_syscall(uint32_t *cmd)
+{
+    (void)cmd;
+
+    return CY_P64_SUCCESS;
+}
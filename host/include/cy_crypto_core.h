@@ -0,0 +1,24 @@
+/***************************************************************************//**
+* \file cy_crypto_core.h
+* \version 1.0
+*
+* \brief
+* The host stand-in for the PDL cy_crypto_core.h header. There is no Crypto block on
+* the host: CY_IP_MXCRYPTO is not defined, so the crypto dispatcher passes
+* all operations to the Secure FlashBoot syscalls.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef CY_CRYPTO_CORE_H
+#define CY_CRYPTO_CORE_H
+
+#include "cy_device.h"
+
+#endif /* CY_CRYPTO_CORE_H */
@@ -0,0 +1,73 @@
+/***************************************************************************//**
+* \file cy_device.h
+* \version 1.0
+*
+* \brief
+* The host stand-in for the PDL device header. It provides only the device
+* definitions used by the p64_utils sources built on the host.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef CY_DEVICE_H
+#define CY_DEVICE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* PSoC64 2M device memory map */
+#define CY_FLASH_BASE                   (0x10000000UL)
+#define CY_FLASH_SIZE                   (0x001D0000UL)
+#define CY_EM_EEPROM_BASE               (0x14000000UL)
+#define CY_EM_EEPROM_SIZE               (0x00008000UL)
+#define CY_SRAM_BASE                    (0x08000000UL)
+#define CY_SRAM_SIZE                    (0x000FF800UL)
+#define SRSS_BASE                       (0x40260000UL)
+
+/* The device UID fields of SFLASH, defined by cy_p64_syscall_host.c */
+typedef struct
+{
+    uint8_t DIE_LOT[3];
+    uint8_t DIE_WAFER;
+    uint8_t DIE_X;
+    uint8_t DIE_Y;
+    uint8_t DIE_SORT;
+    uint8_t DIE_MINOR;
+    uint8_t DIE_DAY;
+    uint8_t DIE_MONTH;
+    uint8_t DIE_YEAR;
+} SFLASH_Type;
+
+extern const SFLASH_Type cy_p64_host_sflash;
+#define SFLASH                          (&cy_p64_host_sflash)
+
+#define CY_CPU_CORTEX_M0P               (0u)
+#define CY_CPU_CORTEX_M4                (0u)
+
+#define CY_GET_REG32(addr)              (*((const volatile uint32_t *)(addr)))
+#define CY_SET_REG32(addr, value)       (*((volatile uint32_t *)(addr)) = (uint32_t)(value))
+#define _VAL2FLD(field, value)          (((uint32_t)(value) << field ## _Pos) & field ## _Msk)
+#define _FLD2VAL(field, value)          (((uint32_t)(value) & field ## _Msk) >> field ## _Pos)
+
+#define CY_LO8(x)                       ((uint8_t) ((x) & 0xFFU))
+#define CY_LO16(x)                      ((uint16_t)((x) & 0xFFFFU))
+#define CY_HI16(x)                      ((uint16_t)(((uint32_t)(x) >> 16U) & 0xFFFFU))
+
+#define CY_RAMFUNC_BEGIN
+#define CY_RAMFUNC_END
+#define CY_NOINLINE                     __attribute__((noinline))
+#define CY_UNUSED_PARAMETER(x)          ((void)(x))
+
+#define CY_ASSERT(x)                    ((void)(x))
+#define CY_ASSERT_L1(x)                 ((void)(x))
+#define CY_ASSERT_L2(x)                 ((void)(x))
+#define CY_ASSERT_L3(x)                 ((void)(x))
+
+#endif /* CY_DEVICE_H */
@@ -0,0 +1,27 @@
+/***************************************************************************//**
+* \file cy_flash.h
+* \version 1.0
+*
+* \brief
+* The host stand-in for the PDL flash driver header. It provides only the
+* flash geometry, the flash operations are implemented by the flash simulator
+* in cy_p64_flash_sim.c.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef CY_FLASH_H
+#define CY_FLASH_H
+
+#include "cy_device.h"
+
+#define CY_FLASH_SIZEOF_ROW                 (512u)
+#define CY_FLASH_SIZEOF_ROW_LONG_UNITS      (CY_FLASH_SIZEOF_ROW / sizeof(uint32_t))
+
+#endif /* CY_FLASH_H */
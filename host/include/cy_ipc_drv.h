@@ -0,0 +1,22 @@
+/***************************************************************************//**
+* \file cy_ipc_drv.h
+* \version 1.0
+*
+* \brief
+* The host stand-in for the PDL cy_ipc_drv.h header.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef CY_IPC_DRV_H
+#define CY_IPC_DRV_H
+
+#include "cy_device.h"
+
+#endif /* CY_IPC_DRV_H */
@@ -0,0 +1,35 @@
+/***************************************************************************//**
+* \file cy_syslib.h
+* \version 1.0
+*
+* \brief
+* The host stand-in for the PDL cy_syslib.h header. The host code runs in
+* one thread, the critical section does nothing.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef CY_SYSLIB_H
+#define CY_SYSLIB_H
+
+#include "cy_device.h"
+
+#define CY_NOINIT                       __attribute__((section(".noinit")))
+
+static inline uint32_t Cy_SysLib_EnterCriticalSection(void)
+{
+    return 0u;
+}
+
+static inline void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus)
+{
+    (void)savedIntrStatus;
+}
+
+#endif /* CY_SYSLIB_H */
@@ -0,0 +1,74 @@
+/***************************************************************************//**
+* \file cy_wdt.h
+* \version 1.0
+*
+* \brief
+* The host stand-in for the PDL WDT driver header. There is no WDT on the
+* host, it is reported as disabled and the configuration is ignored.
+*
+********************************************************************************
+* \copyright
+* Copyright 2022, Cypress Semiconductor Corporation (an Infineon company).
+* All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#ifndef CY_WDT_H
+#define CY_WDT_H
+
+#include "cy_device.h"
+
+#define WDT_MAX_MATCH_VALUE             (0xFFFFuL)
+
+static inline void Cy_WDT_Enable(void)
+{
+}
+
+static inline void Cy_WDT_Disable(void)
+{
+}
+
+static inline void Cy_WDT_Lock(void)
+{
+}
+
+static inline void Cy_WDT_Unlock(void)
+{
+}
+
+static inline void Cy_WDT_MaskInterrupt(void)
+{
+}
+
+static inline void Cy_WDT_SetIgnoreBits(uint32_t bitsNum)
+{
+    (void)bitsNum;
+}
+
+static inline uint32_t Cy_WDT_GetIgnoreBits(void)
+{
+    return 0u;
+}
+
+static inline void Cy_WDT_SetMatch(uint32_t match)
+{
+    (void)match;
+}
+
+static inline uint32_t Cy_WDT_GetCount(void)
+{
+    return 0u;
+}
+
+static inline bool Cy_WDT_IsEnabled(void)
+{
+    return false;
+}
+
+static inline void Cy_WDT_ClearWatchdog(void)
+{
+}
+
+#endif /* CY_WDT_H */